@@ -0,0 +1,84 @@
+#include "arena.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "memory.h"
+
+// The size of a block if no larger allocation is needed.
+#define BLOCK_SIZE ((size_t)1 << 16)
+
+#define ALIGN(size) (((size) + sizeof(max_align_t) - 1) / sizeof(max_align_t) * sizeof(max_align_t))
+
+static void add_block(struct Arena* const arena, const size_t minimum) {
+    const size_t size = minimum > BLOCK_SIZE ? ALIGN(minimum) : BLOCK_SIZE;
+
+    struct ArenaBlock* const block = calloc(1, sizeof(struct ArenaBlock) + size);
+    if(block == NULL) {
+        out_of_memory();
+    }
+
+    block->previous = arena->block;
+    block->size = size;
+    arena->block = block;
+}
+
+void* arena_alloc(struct Arena* const arena, const size_t size) {
+    const size_t aligned = ALIGN(size);
+
+    if(arena->block == NULL || arena->block->size - arena->block->used < aligned) {
+        add_block(arena, aligned);
+    }
+
+    void* const pointer = (char*)arena->block->data + arena->block->used;
+    arena->block->used += aligned;
+
+    return pointer;
+}
+
+void* arena_resize(struct Arena* const arena, void* const pointer, const size_t old_size, const size_t new_size) {
+    struct ArenaBlock* const block = arena->block;
+
+    // Only the last allocation can grow or shrink in place.
+    if(pointer != NULL && block != NULL && (char*)pointer + ALIGN(old_size) == (char*)block->data + block->used) {
+        const size_t start = (size_t)((char*)pointer - (char*)block->data);
+
+        if(new_size <= old_size) {
+            // The freed part has to be zero for the next allocation.
+            memset((char*)pointer + new_size, 0, ALIGN(old_size) - new_size);
+            block->used = start + ALIGN(new_size);
+            return pointer;
+        }
+
+        if(block->size - start >= ALIGN(new_size)) {
+            block->used = start + ALIGN(new_size);
+            return pointer;
+        }
+    }
+
+    void* const resized = arena_alloc(arena, new_size);
+    if(pointer != NULL) {
+        memcpy(resized, pointer, old_size < new_size ? old_size : new_size);
+    }
+
+    return resized;
+}
+
+char* arena_string(struct Arena* const arena, const char* const string, const size_t length) {
+    char* const copy = arena_alloc(arena, length + 1);
+    memcpy(copy, string, length);
+
+    return copy;
+}
+
+void free_arena(struct Arena* const arena) {
+    struct ArenaBlock* block = arena->block;
+
+    while(block != NULL) {
+        struct ArenaBlock* const previous = block->previous;
+        free(block);
+        block = previous;
+    }
+
+    arena->block = NULL;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <stddef.h>
+
+struct ArenaBlock {
+    struct ArenaBlock* previous;
+
+    size_t size;
+    size_t used;
+
+    // The memory of the block directly follows the header.
+    max_align_t data[];
+};
+
+/* Hands out memory from large blocks, so that many small allocations
+ * end up next to each other and can all be freed at once.
+ * A zero initialized arena is empty and ready to be used.
+ */
+struct Arena {
+    struct ArenaBlock* block;
+};
+
+/* Allocates zeroed memory that lives until the arena is freed.
+ *
+ * @return The memory (it never returns NULL).
+ */
+void* arena_alloc(struct Arena* const arena, const size_t size);
+
+/* Changes the size of an allocation. If it was the last allocation
+ * and there is enough space left, it is resized in place.
+ *
+ * @return The (possibly moved) memory.
+ */
+void* arena_resize(struct Arena* const arena, void* const pointer, const size_t old_size, const size_t new_size);
+
+// Copies the characters into a null terminated string.
+char* arena_string(struct Arena* const arena, const char* const string, const size_t length);
+
+void free_arena(struct Arena* const arena);
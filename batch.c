@@ -0,0 +1,325 @@
+#include "batch.h"
+
+#include <dirent.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "arena.h"
+#include "compiled.h"
+#include "cycle.h"
+#include "decide.h"
+#include "memory.h"
+#include "parser.h"
+#include "pool.h"
+#include "table.h"
+
+struct Batch {
+    const struct BatchOptions* options;
+
+    const char** paths;
+    size_t size;
+
+    struct BatchResult* results;
+};
+
+static int compare_paths(const void* const first, const void* const second) {
+    return strcmp(*(const char* const*)first, *(const char* const*)second);
+}
+
+static void add_path(const char*** const paths, size_t* const size, size_t* const allocated, const char* const path) {
+    if(*size >= *allocated) {
+        *allocated = *allocated == 0 ? 64 : *allocated * 2;
+        *paths = realloc(*paths, sizeof(const char*) * *allocated);
+
+        if(*paths == NULL) {
+            out_of_memory();
+        }
+    }
+
+    (*paths)[(*size)++] = path;
+}
+
+/* Collects the `.tau` files of the directory in the order of their names.
+ *
+ * @return 1 if it was successful and 0 if the directory could not be read.
+ */
+static int list_directory(struct Batch* const batch, const char* const directory, struct Arena* const arena) {
+    DIR* const dir = opendir(directory);
+    if(dir == NULL) {
+        return 0;
+    }
+
+    size_t allocated = 0;
+    const size_t directory_length = strlen(directory);
+
+    struct dirent* entry;
+    while((entry = readdir(dir)) != NULL) {
+        const size_t length = strlen(entry->d_name);
+
+        if(length <= 4 || strcmp(entry->d_name + length - 4, ".tau") != 0) {
+            continue;
+        }
+
+        char* const path = arena_alloc(arena, directory_length + length + 2);
+        memcpy(path, directory, directory_length);
+        path[directory_length] = '/';
+        memcpy(path + directory_length + 1, entry->d_name, length);
+
+        add_path(&batch->paths, &batch->size, &allocated, path);
+    }
+
+    closedir(dir);
+
+    if(batch->size > 0) {
+        qsort(batch->paths, batch->size, sizeof(const char*), compare_paths);
+    }
+
+    return 1;
+}
+
+// Collects the paths of the manifest.
+static int list_manifest(struct Batch* const batch, const char* const manifest, struct Arena* const arena) {
+    struct MappedFile file;
+    if(!map_file(&file, manifest)) {
+        return 0;
+    }
+
+    size_t allocated = 0;
+    size_t start = 0;
+
+    while(start < file.size) {
+        const char* const newline = memchr(file.content + start, '\n', file.size - start);
+        const size_t end = newline == NULL ? file.size : (size_t)(newline - file.content);
+
+        // Trailing whitespace (like the `\r` of Windows line endings) is not part of the path.
+        size_t last = end;
+        while(last > start && (file.content[last - 1] == ' ' || file.content[last - 1] == '\t' || file.content[last - 1] == '\r')) {
+            --last;
+        }
+
+        if(last > start && file.content[start] != '#') {
+            add_path(&batch->paths, &batch->size, &allocated, arena_string(arena, file.content + start, last - start));
+        }
+
+        start = end + 1;
+    }
+
+    unmap_file(&file);
+
+    return 1;
+}
+
+static struct TuringMachine* load_machine(const char* const path) {
+    struct MappedFile file;
+    if(!map_file(&file, path)) {
+        fprintf(stderr, "File path `%s` does not exist.\n", path);
+        return NULL;
+    }
+
+    if(is_compiled(&file)) {
+        struct TuringMachine* const machine = load_compiled(&file);
+        unmap_file(&file);
+
+        if(machine == NULL) {
+            fprintf(stderr, "`%s` is not a valid compiled machine.\n", path);
+        }
+        return machine;
+    }
+
+    unmap_file(&file);
+
+    int status;
+    return parse(path, &status);
+}
+
+size_t used_cells(const Symbol* const cells, const size_t size, const Symbol def) {
+    size_t first = 0;
+    while(first < size && cells[first] == def) {
+        ++first;
+    }
+
+    size_t last = size;
+    while(last > first && cells[last - 1] == def) {
+        --last;
+    }
+
+    return last - first;
+}
+
+static size_t used_bytes(const uint8_t* const cells, const size_t size, const uint8_t def) {
+    size_t first = 0;
+    while(first < size && cells[first] == def) {
+        ++first;
+    }
+
+    size_t last = size;
+    while(last > first && cells[last - 1] == def) {
+        --last;
+    }
+
+    return last - first;
+}
+
+static size_t used_bits(const struct BitTape* const tape) {
+    const uint64_t blank = tape->def ? ~(uint64_t)0 : 0;
+
+    size_t first = 0;
+    while(first < tape->size && tape->words[first] == blank) {
+        ++first;
+    }
+
+    if(first == tape->size) {
+        return 0;
+    }
+
+    size_t last = tape->size - 1;
+    while(tape->words[last] == blank) {
+        --last;
+    }
+
+    // The bits that are different from the blank in the first and last word
+    const size_t low = __builtin_ctzll(tape->words[first] ^ blank);
+    const size_t high = 63 - __builtin_clzll(tape->words[last] ^ blank);
+
+    return (last * 64 + high) - (first * 64 + low) + 1;
+}
+
+const char* batch_status_name(const enum BatchStatus status) {
+    switch(status) {
+    case BATCH_HALTED:
+        return "halted";
+    case BATCH_LOOPED:
+        return "looped";
+    case BATCH_BUDGET:
+        return "budget";
+    case BATCH_ERROR:
+        break;
+    }
+
+    return "error";
+}
+
+struct BatchResult run_batch_tape(const struct TransitionTable* const table, struct Tape* const tape, const struct BatchOptions* const options, struct Exporter* const exporter) {
+    struct BatchResult result = {0};
+
+    StateId state = table->start;
+    struct BitTape bits;
+    struct ByteTape bytes;
+    struct Cycle cycle = {0};
+
+    if(options->cycles) {
+        result.steps = run_table_cycles(table, tape, &state, options->max_iter, &cycle);
+        result.tape_size = used_cells(tape->content, tape->size, tape->def);
+        if(exporter != NULL) {
+            export_cells(exporter, tape->content, tape->size);
+        }
+    } else if(init_bit_tape(&bits, tape)) {
+        result.steps = run_table_bits(table, &bits, &state, options->max_iter);
+        result.tape_size = used_bits(&bits);
+        if(exporter != NULL) {
+            export_bit_tape(exporter, &bits);
+        }
+        free_bit_tape(&bits);
+    } else if(init_byte_tape(&bytes, tape)) {
+        result.steps = run_table_bytes(table, &bytes, &state, options->max_iter);
+        result.tape_size = used_bytes(bytes.content, bytes.size, bytes.def);
+        if(exporter != NULL) {
+            export_byte_tape(exporter, &bytes);
+        }
+        free_byte_tape(&bytes);
+    } else {
+        result.steps = run_table(table, tape, &state, options->max_iter);
+        result.tape_size = used_cells(tape->content, tape->size, tape->def);
+        if(exporter != NULL) {
+            export_cells(exporter, tape->content, tape->size);
+        }
+    }
+
+    if(state == table->halt) {
+        result.status = BATCH_HALTED;
+    } else {
+        result.status = cycle.period > 0 ? BATCH_LOOPED : BATCH_BUDGET;
+    }
+
+    return result;
+}
+
+static struct BatchResult run_machine(struct TuringMachine* const machine, const struct BatchOptions* const options) {
+    struct BatchResult result = {0};
+    struct Tape* const tape = &machine->tape;
+
+    if(options->decide && decide(machine) != VERDICT_UNKNOWN) {
+        result.status = BATCH_LOOPED;
+        result.tape_size = used_cells(tape->content, tape->size, tape->def);
+        return result;
+    }
+
+    struct TransitionTable table;
+    if(!compile_table(&table, machine)) {
+        while(machine->state != NULL && result.steps < options->max_iter) {
+            next_state(machine);
+            ++result.steps;
+        }
+
+        result.status = machine->state == NULL ? BATCH_HALTED : BATCH_BUDGET;
+        result.tape_size = used_cells(tape->content, tape->size, tape->def);
+        return result;
+    }
+
+    result = run_batch_tape(&table, tape, options, NULL);
+
+    free_table(&table);
+
+    return result;
+}
+
+static void run_job(void* const context, const size_t index, const size_t worker) {
+    (void)worker;
+
+    struct Batch* const batch = context;
+
+    struct TuringMachine* const machine = load_machine(batch->paths[index]);
+    if(machine == NULL) {
+        batch->results[index] = (struct BatchResult){.status = BATCH_ERROR};
+        return;
+    }
+
+    batch->results[index] = run_machine(machine, batch->options);
+
+    free_machine(machine);
+}
+
+int run_batch(const char* const input, const struct BatchOptions* const options, FILE* const out) {
+    struct Batch batch = {
+        .options = options
+    };
+    struct Arena arena = {0};
+
+    struct stat status;
+    const bool directory = stat(input, &status) == 0 && S_ISDIR(status.st_mode);
+
+    if(!(directory ? list_directory(&batch, input, &arena) : list_manifest(&batch, input, &arena))) {
+        fprintf(stderr, "File path `%s` does not exist.\n", input);
+        free_arena(&arena);
+        return 1;
+    }
+
+    batch.results = malloc(sizeof(struct BatchResult) * (batch.size > 0 ? batch.size : 1));
+    if(batch.results == NULL) {
+        out_of_memory();
+    }
+
+    run_pool(batch.size, options->threads, run_job, &batch);
+
+    for(size_t i = 0; i < batch.size; ++i) {
+        const struct BatchResult* const result = &batch.results[i];
+
+        fprintf(out, "%s\t%s\t%zu\t%zu\n", batch.paths[i], batch_status_name(result->status), result->steps, result->tape_size);
+    }
+
+    free(batch.results);
+    free(batch.paths);
+    free_arena(&arena);
+
+    return 0;
+}
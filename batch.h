@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "export.h"
+#include "table.h"
+
+struct BatchOptions {
+    size_t max_iter;
+    // The amount of threads or 0 for one per core
+    size_t threads;
+    bool cycles;
+    bool decide;
+};
+
+enum BatchStatus {
+    BATCH_ERROR,
+    BATCH_HALTED,
+    BATCH_LOOPED,
+    BATCH_BUDGET
+};
+
+struct BatchResult {
+    enum BatchStatus status;
+    size_t steps;
+    size_t tape_size;
+};
+
+// The name of the status in the output.
+const char* batch_status_name(const enum BatchStatus status);
+
+// The amount of cells from the first to the last one that is not blank.
+size_t used_cells(const Symbol* const cells, const size_t size, const Symbol def);
+
+/* Runs the table on the narrowest tape that can hold its symbols (or with
+ * cycle detection on the tape itself). Nothing but the tape is changed,
+ * so the same table can be used by several threads at once.
+ * If `exporter` is not NULL, the final tape is exported into it.
+ */
+struct BatchResult run_batch_tape(const struct TransitionTable* const table, struct Tape* const tape, const struct BatchOptions* const options, struct Exporter* const exporter);
+
+/* Runs every machine of a directory (all `.tau` files) or a manifest
+ * (one path per line, empty lines and lines starting with `#` are skipped)
+ * on a pool of threads. One line is written per machine in the same order:
+ *
+ *   <path>\t<result>\t<steps>\t<tape size>
+ *
+ * The result is `halted`, `looped` (if it was proven that it never halts),
+ * `budget` (if the maximum amount of iterations was reached) or `error`.
+ * The tape size is the amount of cells from the leftmost to the rightmost
+ * cell that is not blank.
+ *
+ * @return The exit code of the program.
+ */
+int run_batch(const char* const input, const struct BatchOptions* const options, FILE* const out);
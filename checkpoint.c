@@ -0,0 +1,301 @@
+#include "checkpoint.h"
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "export.h"
+#include "memory.h"
+#include "tapefile.h"
+
+static const char magic[] = "TAU checkpoint 1";
+
+// The head is written with a fixed width, so that it can be filled in once the tape is written.
+#define HEAD_FORMAT "head %+021lld\n"
+
+struct SymbolRun {
+    Symbol symbol;
+    size_t length;
+};
+
+// A checkpoint that is being written
+struct CheckpointFile {
+    char* temp;
+    FILE* out;
+    long head;
+    struct Exporter exporter;
+};
+
+/* Opens the temporary file and writes everything in front of the tape.
+ *
+ * @return 1 if it was successful and 0 otherwise.
+ */
+static int begin_checkpoint(struct CheckpointFile* const file, const char* const path, const struct Checkpoint* const checkpoint, const struct Tape* const symbols) {
+    file->temp = malloc(strlen(path) + sizeof(".tmp"));
+    if(file->temp == NULL) {
+        out_of_memory();
+    }
+    strcpy(file->temp, path);
+    strcat(file->temp, ".tmp");
+
+    file->out = fopen(file->temp, "w");
+    if(file->out == NULL) {
+        free(file->temp);
+        return 0;
+    }
+
+    fprintf(file->out, "%s\nsource %016" PRIx64 "\nstate %" PRIu32 "\nsteps %zu\n", magic, checkpoint->source_hash, checkpoint->state, checkpoint->steps);
+    file->head = ftell(file->out);
+    fprintf(file->out, HEAD_FORMAT, 0ll);
+
+    init_exporter(&file->exporter, file->out, EXPORT_RLE, symbols);
+
+    return 1;
+}
+
+/* Writes the position of the head (the index of its cell in the exported cells)
+ * and replaces the last checkpoint.
+ *
+ * @return 1 if it was successful and 0 otherwise.
+ */
+static int finish_checkpoint(struct CheckpointFile* const file, const char* const path, const size_t cursor) {
+    int written = finish_export(&file->exporter);
+
+    // Leading blanks are not written, so the head is counted from the first cell that is not blank.
+    const long long head = file->exporter.started ? (long long)cursor - (long long)file->exporter.skipped : 0;
+
+    if(written && (fseek(file->out, file->head, SEEK_SET) != 0 || fprintf(file->out, HEAD_FORMAT, head) < 0)) {
+        written = 0;
+    }
+    if(fclose(file->out) != 0) {
+        written = 0;
+    }
+
+    if(!written || rename(file->temp, path) != 0) {
+        remove(file->temp);
+        written = 0;
+    }
+
+    free(file->temp);
+
+    return written;
+}
+
+int write_checkpoint_bits(const char* const path, const struct Checkpoint* const checkpoint, const struct Tape* const symbols, const struct BitTape* const tape) {
+    struct CheckpointFile file;
+    if(!begin_checkpoint(&file, path, checkpoint, symbols)) {
+        return 0;
+    }
+
+    export_bits(&file.exporter, tape->words, 0, tape->size * 64);
+
+    return finish_checkpoint(&file, path, tape->cursor);
+}
+
+int write_checkpoint_bytes(const char* const path, const struct Checkpoint* const checkpoint, const struct Tape* const symbols, const struct ByteTape* const tape) {
+    struct CheckpointFile file;
+    if(!begin_checkpoint(&file, path, checkpoint, symbols)) {
+        return 0;
+    }
+
+    export_bytes(&file.exporter, tape->content, tape->size);
+
+    return finish_checkpoint(&file, path, tape->cursor);
+}
+
+int write_checkpoint_cells(const char* const path, const struct Checkpoint* const checkpoint, const struct Tape* const tape) {
+    struct CheckpointFile file;
+    if(!begin_checkpoint(&file, path, checkpoint, tape)) {
+        return 0;
+    }
+
+    export_cells(&file.exporter, tape->content, tape->size);
+
+    return finish_checkpoint(&file, path, tape->cursor);
+}
+
+static void invalid_checkpoint(const char* const file_name, const size_t line) {
+    fprintf(stderr, "\033[31mLine %zu of the checkpoint `%s` is not valid.\033[0m\n", line, file_name);
+    exit(10);
+}
+
+/* Finds the next line of the file.
+ *
+ * @return false if there are no lines left.
+ */
+static bool next_line(const struct MappedFile* const file, size_t* const position, const char** const line, size_t* const length) {
+    if(*position >= file->size) {
+        return false;
+    }
+
+    const char* const start = file->content + *position;
+    const char* const newline = memchr(start, '\n', file->size - *position);
+    const size_t end = newline == NULL ? file->size : (size_t)(newline - file->content);
+
+    *line = start;
+    *length = end - *position;
+    *position = end + 1;
+
+    // Windows line endings
+    if(*length > 0 && start[*length - 1] == '\r') {
+        --*length;
+    }
+
+    return true;
+}
+
+/* Copies a line of the header, so that it can be read with `sscanf`.
+ *
+ * @return false if the file ended or the line is too long for a header.
+ */
+static bool header_line(const struct MappedFile* const file, size_t* const position, char* const buffer, const size_t size) {
+    const char* line;
+    size_t length;
+
+    if(!next_line(file, position, &line, &length) || length >= size) {
+        return false;
+    }
+
+    memcpy(buffer, line, length);
+    buffer[length] = '\0';
+
+    return true;
+}
+
+// Reads a line `<length> <name>` of the tape.
+static bool read_run(const struct SymbolLookup* const lookup, const char* const line, const size_t length, Symbol* const cells, struct SymbolRun* const run) {
+    const char* const space = memchr(line, ' ', length);
+    if(space == NULL || space == line) {
+        return false;
+    }
+
+    run->length = 0;
+    for(const char* digit = line; digit < space; ++digit) {
+        if(*digit < '0' || *digit > '9' || run->length > (SIZE_MAX - 9) / 10) {
+            return false;
+        }
+        run->length = run->length * 10 + (size_t)(*digit - '0');
+    }
+
+    const char* const name = space + 1;
+    const size_t name_length = length - (size_t)(name - line);
+
+    size_t count;
+    size_t error;
+    if(!decode_names(lookup, name, name_length, cells, &count, &error) || count != 1) {
+        return false;
+    }
+
+    run->symbol = cells[0];
+
+    return run->length > 0;
+}
+
+int load_checkpoint(struct TuringMachine* const machine, const char* const file_name, const uint64_t source_hash, size_t* const steps) {
+    struct MappedFile file;
+    if(!map_file(&file, file_name)) {
+        return 0;
+    }
+
+    size_t position = 0;
+    char buffer[64];
+
+    uint64_t source;
+    uint32_t state;
+    long long head;
+
+    if(!header_line(&file, &position, buffer, sizeof(buffer)) || strcmp(buffer, magic) != 0) {
+        invalid_checkpoint(file_name, 1);
+    }
+    if(!header_line(&file, &position, buffer, sizeof(buffer)) || sscanf(buffer, "source %" SCNx64, &source) != 1) {
+        invalid_checkpoint(file_name, 2);
+    }
+    if(!header_line(&file, &position, buffer, sizeof(buffer)) || sscanf(buffer, "state %" SCNu32, &state) != 1 || state >= machine->states_size) {
+        invalid_checkpoint(file_name, 3);
+    }
+    if(!header_line(&file, &position, buffer, sizeof(buffer)) || sscanf(buffer, "steps %zu", steps) != 1) {
+        invalid_checkpoint(file_name, 4);
+    }
+    if(!header_line(&file, &position, buffer, sizeof(buffer)) || sscanf(buffer, "head %lld", &head) != 1) {
+        invalid_checkpoint(file_name, 5);
+    }
+
+    if(source != source_hash) {
+        fprintf(stderr, "\033[31mThe checkpoint `%s` was written for another source.\033[0m\n", file_name);
+        exit(10);
+    }
+
+    // The runs are collected first, as the size of the tape is only known at the end.
+    struct SymbolLookup lookup = init_symbol_lookup(&machine->tape);
+    struct SymbolRun* runs = NULL;
+    size_t runs_size = 0;
+    size_t allocated = 0;
+    size_t cells = 0;
+
+    Symbol* names = NULL;
+    size_t names_allocated = 0;
+
+    const char* line;
+    size_t length;
+    for(size_t number = 6; next_line(&file, &position, &line, &length); ++number) {
+        if(length == 0) {
+            continue;
+        }
+
+        // `decode_names` needs room for every name that could be in the line.
+        if(length / 2 + 1 > names_allocated) {
+            names_allocated = length / 2 + 1;
+            free(names);
+            names = malloc(sizeof(Symbol) * names_allocated);
+
+            if(names == NULL) {
+                out_of_memory();
+            }
+        }
+
+        if(runs_size >= allocated) {
+            allocated = allocated == 0 ? 64 : allocated * 2;
+            runs = realloc(runs, sizeof(struct SymbolRun) * allocated);
+
+            if(runs == NULL) {
+                out_of_memory();
+            }
+        }
+
+        if(!read_run(&lookup, line, length, names, &runs[runs_size]) || runs[runs_size].length > SIZE_MAX / 4 - cells) {
+            invalid_checkpoint(file_name, number);
+        }
+
+        cells += runs[runs_size++].length;
+    }
+
+    free(names);
+    free_symbol_lookup(&lookup);
+    unmap_file(&file);
+
+    // The head can also be on a blank outside of the written cells.
+    const long long first = head < 0 ? head : 0;
+    const long long last = head >= (long long)cells ? head + 1 : (long long)cells;
+
+    struct Tape loaded = init_tape_blank(machine->tape.def, (size_t)(last - first));
+
+    Symbol* cell = loaded.content - first;
+    for(size_t i = 0; i < runs_size; ++i) {
+        for(size_t j = 0; j < runs[i].length; ++j) {
+            *cell++ = runs[i].symbol;
+        }
+    }
+    loaded.cursor = (size_t)(head - first);
+
+    free(runs);
+
+    loaded.symbol_names = machine->tape.symbol_names;
+    loaded.symbol_len = machine->tape.symbol_len;
+
+    free_tape(&machine->tape);
+    machine->tape = loaded;
+    machine->state = &machine->states[state];
+
+    return 1;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "narrowtape.h"
+#include "table.h"
+#include "turingmachine.h"
+
+// The steps between two checkpoints if nothing else is given.
+#define CHECKPOINT_EVERY 1000000000
+
+/* A checkpoint stores the configuration of a machine that is still running,
+ * so that it can continue later. It is a text file:
+ *
+ *   TAU checkpoint 1
+ *   source <hash of the source in hex>
+ *   state <ID of the current state>
+ *   steps <steps that were done>
+ *   head <position of the head from the first cell that is not blank>
+ *   <length> <name>
+ *   ...
+ *
+ * The tape is written like `--export-format rle` from the first to the last
+ * cell that is not blank, so long runs of the same symbol only take one line.
+ */
+struct Checkpoint {
+    uint64_t source_hash;
+    StateId state;
+    size_t steps;
+};
+
+/* Writes the checkpoint with the tape into `<path>.tmp` and then renames it to `path`,
+ * so that a run that is killed while writing keeps the last checkpoint.
+ * `symbols` is the tape of the machine, which has the names of the symbols.
+ *
+ * @return 1 if it was successful and 0 otherwise.
+ */
+int write_checkpoint_bits(const char* const path, const struct Checkpoint* const checkpoint, const struct Tape* const symbols, const struct BitTape* const tape);
+
+int write_checkpoint_bytes(const char* const path, const struct Checkpoint* const checkpoint, const struct Tape* const symbols, const struct ByteTape* const tape);
+
+int write_checkpoint_cells(const char* const path, const struct Checkpoint* const checkpoint, const struct Tape* const tape);
+
+/* Replaces the tape and the current state of the machine with the ones of the
+ * checkpoint and reads the steps that were done before into `steps`.
+ *
+ * @return 1 if it was successful and 0 if the file could not be opened.
+ *         Checkpoints that are invalid or of another source end the program with an error.
+ */
+int load_checkpoint(struct TuringMachine* const machine, const char* const file_name, const uint64_t source_hash, size_t* const steps);
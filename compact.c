@@ -0,0 +1,362 @@
+#include "compact.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "decide.h"
+#include "memory.h"
+#include "pool.h"
+#include "table.h"
+
+// The layout of the seed database
+#define DATABASE_HEADER 30
+#define DATABASE_MACHINE 30
+#define DATABASE_STATES 5
+#define DATABASE_SYMBOLS 2
+
+struct MachineResult {
+    bool done;
+    struct BatchResult result;
+};
+
+struct Machines {
+    const struct BatchOptions* options;
+
+    struct MappedFile file;
+    bool database;
+    // Where the machines of a text file start
+    size_t* lines;
+    // The amount of machines in the file
+    size_t size;
+
+    // The machines that are run
+    size_t from;
+    size_t to;
+
+    // The machines that are run by the pool at the moment
+    size_t start;
+    size_t window;
+
+    struct MachineResult* results;
+    // Every thread reads its machines into its own one.
+    struct CompactMachine* workers;
+
+    // Protects the results and the output.
+    pthread_mutex_t lock;
+    size_t next;
+    FILE* out;
+};
+
+// Prepares an empty machine with the given size.
+static void init_compact(struct CompactMachine* const compact, const size_t states, const size_t symbols) {
+    for(size_t i = 0; i < states; ++i) {
+        compact->states[i] = (struct State){
+            .rules = compact->rules + i * symbols
+        };
+    }
+
+    compact->blank = 0;
+    compact->machine = (struct TuringMachine){
+        // The deciders only look at the blank tape the machine starts on.
+        .tape = {
+            .content = &compact->blank,
+            .size = 1,
+            .symbol_len = symbols
+        },
+        .state = compact->states,
+        .states = compact->states,
+        .states_size = states
+    };
+}
+
+static bool is_separator(const char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+/* Reads a single rule like `1RB`.
+ *
+ * @return true if it was successful.
+ */
+static bool read_rule(struct CompactMachine* const compact, const char* const text, const size_t states, const size_t symbols, struct Rule* const rule) {
+    if(memcmp(text, "---", 3) == 0) {
+        *rule = (struct Rule){.direction = RIGHT};
+        return true;
+    }
+
+    if(text[0] < '0' || text[0] >= '0' + (int)symbols || (text[1] != 'L' && text[1] != 'R') || text[2] < 'A' || text[2] > 'Z') {
+        return false;
+    }
+
+    const size_t next = text[2] - 'A';
+
+    *rule = (struct Rule){
+        .write_symbol = text[0] - '0',
+        .direction = text[1] == 'L' ? LEFT : RIGHT,
+        .next_state = next < states ? &compact->states[next] : NULL
+    };
+
+    return true;
+}
+
+int read_compact(struct CompactMachine* const compact, const char* const text, const size_t length) {
+    // The first state decides how many symbols every state has.
+    const char* const separator = memchr(text, '_', length);
+    const size_t width = separator == NULL ? length : (size_t)(separator - text);
+
+    if(width % 3 != 0 || width / 3 < 2 || width / 3 > COMPACT_MAX_SYMBOLS || (length + 1) % (width + 1) != 0) {
+        return 0;
+    }
+
+    const size_t symbols = width / 3;
+    const size_t states = (length + 1) / (width + 1);
+
+    if(states > COMPACT_MAX_STATES) {
+        return 0;
+    }
+
+    init_compact(compact, states, symbols);
+
+    for(size_t i = 0; i < states; ++i) {
+        const char* const state = text + i * (width + 1);
+
+        if(i > 0 && state[-1] != '_') {
+            return 0;
+        }
+
+        for(size_t j = 0; j < symbols; ++j) {
+            if(!read_rule(compact, state + j * 3, states, symbols, &compact->states[i].rules[j])) {
+                return 0;
+            }
+        }
+    }
+
+    return 1;
+}
+
+// Reads a machine of the seed database.
+static bool read_database(struct CompactMachine* const compact, const uint8_t* const machine) {
+    init_compact(compact, DATABASE_STATES, DATABASE_SYMBOLS);
+
+    for(size_t i = 0; i < DATABASE_STATES * DATABASE_SYMBOLS; ++i) {
+        const uint8_t* const rule = machine + i * 3;
+
+        if(rule[0] >= DATABASE_SYMBOLS || rule[1] > 1 || rule[2] > DATABASE_STATES) {
+            return false;
+        }
+
+        compact->rules[i] = (struct Rule){
+            .write_symbol = rule[0],
+            .direction = rule[1] == 1 ? LEFT : RIGHT,
+            .next_state = rule[2] == 0 ? NULL : &compact->states[rule[2] - 1]
+        };
+    }
+
+    return true;
+}
+
+// The length of the machine at the start of the text.
+static size_t compact_length(const char* const text, const size_t size) {
+    size_t length = 0;
+    while(length < size && !is_separator(text[length])) {
+        ++length;
+    }
+
+    return length;
+}
+
+// Collects where the machines of a text file start.
+static void find_lines(struct Machines* const machines) {
+    const struct MappedFile* const file = &machines->file;
+    size_t allocated = 0;
+    size_t start = 0;
+
+    while(start < file->size) {
+        const char* const newline = memchr(file->content + start, '\n', file->size - start);
+        const size_t end = newline == NULL ? file->size : (size_t)(newline - file->content);
+
+        if(compact_length(file->content + start, end - start) > 0 && file->content[start] != '#') {
+            if(machines->size >= allocated) {
+                allocated = allocated == 0 ? 64 : allocated * 2;
+                machines->lines = realloc(machines->lines, sizeof(size_t) * allocated);
+
+                if(machines->lines == NULL) {
+                    out_of_memory();
+                }
+            }
+
+            machines->lines[machines->size++] = start;
+        }
+
+        start = end + 1;
+    }
+}
+
+static bool load_machine(const struct Machines* const machines, const size_t index, struct CompactMachine* const compact) {
+    if(machines->database) {
+        return read_database(compact, (const uint8_t*)machines->file.content + DATABASE_HEADER + index * DATABASE_MACHINE);
+    }
+
+    const char* const text = machines->file.content + machines->lines[index];
+    return read_compact(compact, text, compact_length(text, machines->file.size - machines->lines[index]));
+}
+
+static struct BatchResult run_compact(struct CompactMachine* const compact, const struct BatchOptions* const options) {
+    struct BatchResult result = {0};
+
+    if(options->decide && decide(&compact->machine) != VERDICT_UNKNOWN) {
+        result.status = BATCH_LOOPED;
+        return result;
+    }
+
+    // Every machine of the compact notation is small enough for a table.
+    struct TransitionTable table;
+    compile_table(&table, &compact->machine);
+
+    // A small tape on the heap that only grows as far as the machine goes, as most machines only use a few cells.
+    struct Tape tape = {
+        .content = calloc(16, sizeof(Symbol)),
+        .size = 16,
+        .cursor = 8,
+        .symbol_len = compact->machine.tape.symbol_len
+    };
+    if(tape.content == NULL) {
+        out_of_memory();
+    }
+
+    // The narrow tapes would reserve and commit memory for every machine, which
+    // takes longer than running most of them.
+    if(options->cycles) {
+        result = run_batch_tape(&table, &tape, options, NULL);
+    } else {
+        StateId state = table.start;
+        result.steps = run_table(&table, &tape, &state, options->max_iter);
+        result.status = state == table.halt ? BATCH_HALTED : BATCH_BUDGET;
+        result.tape_size = used_cells(tape.content, tape.size, tape.def);
+    }
+
+    free_tape(&tape);
+    free_table(&table);
+
+    return result;
+}
+
+// Writes all results that are done and have no unfinished results in front of them.
+static void write_done(struct Machines* const machines) {
+    while(machines->next < machines->window && machines->results[machines->next].done) {
+        const struct BatchResult* const result = &machines->results[machines->next].result;
+
+        fprintf(machines->out, "%zu\t%s\t%zu\t%zu\n", machines->start + machines->next, batch_status_name(result->status), result->steps, result->tape_size);
+
+        ++machines->next;
+    }
+}
+
+static void run_job(void* const context, const size_t index, const size_t worker) {
+    struct Machines* const machines = context;
+    struct CompactMachine* const compact = &machines->workers[worker];
+    const size_t machine = machines->start + index;
+
+    struct MachineResult result = {.done = true};
+
+    if(load_machine(machines, machine, compact)) {
+        result.result = run_compact(compact, machines->options);
+    } else {
+        fprintf(stderr, "\033[31mMachine %zu is not valid.\033[0m\n", machine);
+        result.result.status = BATCH_ERROR;
+    }
+
+    pthread_mutex_lock(&machines->lock);
+    machines->results[index] = result;
+    write_done(machines);
+    pthread_mutex_unlock(&machines->lock);
+}
+
+/* Reads `<from>,<to>`.
+ *
+ * @return true if both are numbers and `from` is not after `to`.
+ */
+static bool parse_range(const char* const range, size_t* const from, size_t* const to) {
+    char* end;
+    const unsigned long long first = strtoull(range, &end, 10);
+    if(end == range || *end != ',' || range[0] == '-') {
+        return false;
+    }
+
+    const char* const second_start = end + 1;
+    const unsigned long long second = strtoull(second_start, &end, 10);
+    if(end == second_start || *end != '\0' || second_start[0] == '-') {
+        return false;
+    }
+
+    *from = first;
+    *to = second;
+
+    return first <= second;
+}
+
+int run_machines(const char* const path, const char* const range, const struct BatchOptions* const options, FILE* const out) {
+    struct Machines machines = {
+        .options = options,
+        .out = out
+    };
+
+    size_t from = 0;
+    size_t to = SIZE_MAX;
+    if(range != NULL && !parse_range(range, &from, &to)) {
+        fprintf(stderr, "\033[31mThe range has to be `<from>,<to>` with `from` not after `to`.\033[0m\n");
+        return 1;
+    }
+
+    if(!map_file(&machines.file, path)) {
+        fprintf(stderr, "File path `%s` does not exist.\n", path);
+        return 1;
+    }
+
+    // Text never contains a null byte, but the counts in the header of the database do.
+    machines.database = machines.file.size >= DATABASE_HEADER && memchr(machines.file.content, '\0', DATABASE_HEADER) != NULL;
+
+    if(machines.database) {
+        if((machines.file.size - DATABASE_HEADER) % DATABASE_MACHINE != 0) {
+            fprintf(stderr, "\033[31m`%s` is not a valid seed database.\033[0m\n", path);
+            unmap_file(&machines.file);
+            return 1;
+        }
+
+        machines.size = (machines.file.size - DATABASE_HEADER) / DATABASE_MACHINE;
+    } else {
+        find_lines(&machines);
+    }
+
+    machines.from = from < machines.size ? from : machines.size;
+    machines.to = to < machines.size ? to : machines.size;
+
+    const size_t size = machines.to - machines.from;
+    const size_t window = size < POOL_WINDOW ? size : POOL_WINDOW;
+    const size_t workers = pool_size(window, options->threads);
+    machines.results = calloc(window > 0 ? window : 1, sizeof(struct MachineResult));
+    machines.workers = calloc(workers, sizeof(struct CompactMachine));
+    if(machines.results == NULL || machines.workers == NULL) {
+        out_of_memory();
+    }
+    pthread_mutex_init(&machines.lock, NULL);
+
+    // Only one window is kept in memory, so the file can have any amount of machines.
+    for(machines.start = machines.from; machines.start < machines.to; machines.start += machines.window) {
+        machines.window = machines.to - machines.start < window ? machines.to - machines.start : window;
+        machines.next = 0;
+        memset(machines.results, 0, sizeof(struct MachineResult) * machines.window);
+
+        run_pool(machines.window, options->threads, run_job, &machines);
+        fflush(out);
+    }
+
+    pthread_mutex_destroy(&machines.lock);
+    free(machines.results);
+    free(machines.workers);
+    free(machines.lines);
+    unmap_file(&machines.file);
+
+    return 0;
+}
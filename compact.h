@@ -0,0 +1,55 @@
+#pragma once
+
+#include <stdio.h>
+
+#include "batch.h"
+#include "turingmachine.h"
+
+// The most states and symbols the compact notation can name (`A` to `Z` and `0` to `9`).
+#define COMPACT_MAX_STATES 26
+#define COMPACT_MAX_SYMBOLS 10
+
+/* A machine that is read from the compact notation. It has room for the
+ * largest one, so that it can be reused for every machine of a file.
+ */
+struct CompactMachine {
+    struct TuringMachine machine;
+    Symbol blank;
+
+    struct State states[COMPACT_MAX_STATES];
+    struct Rule rules[COMPACT_MAX_STATES * COMPACT_MAX_SYMBOLS];
+};
+
+/* Reads a machine in the compact notation of the busy beaver community, e.g.
+ * `1RB1LC_1RC1RB_1RD0LE_1LA1LD_1RZ0LA`: The states are separated by `_` and every
+ * rule is the written symbol, the direction (`L` or `R`) and the next state.
+ * A next state that is not one of the states (like `Z`) halts, as does `---`.
+ * The machine starts in the first state on a blank tape of the symbol `0`.
+ *
+ * @return 1 if it was successful and 0 if the text is not a valid machine.
+ */
+int read_compact(struct CompactMachine* const compact, const char* const text, const size_t length);
+
+/* Runs the machines of a file on a pool of threads. The file is either text
+ * with one machine in the compact notation per line (anything after the machine
+ * is ignored, as are empty lines and lines starting with `#`) or the binary
+ * seed database of bbchallenge, which is mapped into memory:
+ *
+ *   A header of 30 bytes, followed by 30 bytes per machine with 5 states of
+ *   2 rules with 3 bytes each: The written symbol, the direction (0 for right,
+ *   1 for left) and the next state (1 to 5, 0 if the rule is undefined).
+ *
+ * `range` is `<from>,<to>` to only run the machines with an index from `from`
+ * up to (but not including) `to`, so that a large file can be split between
+ * processes. If it is NULL, all machines are run.
+ *
+ * One line is written per machine in the order of the file, as soon as it and
+ * all of the machines before it are done:
+ *
+ *   <index>\t<result>\t<steps>\t<tape size>
+ *
+ * The index counts the machines of the file from 0, like the IDs of the database.
+ *
+ * @return The exit code of the program.
+ */
+int run_machines(const char* const path, const char* const range, const struct BatchOptions* const options, FILE* const out);
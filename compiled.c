@@ -0,0 +1,224 @@
+#include "compiled.h"
+
+#include <string.h>
+
+static const char magic[4] = {'T', 'A', 'U', 'C'};
+#define VERSION 1
+
+bool is_compiled(const struct MappedFile* const file) {
+    return file->size >= sizeof(struct CompiledHeader) && memcmp(file->content, magic, sizeof(magic)) == 0;
+}
+
+uint64_t hash_source(const struct MappedFile* const file) {
+    return hash_bytes(file->content, file->size);
+}
+
+uint64_t compiled_source_hash(const struct MappedFile* const file) {
+    struct CompiledHeader header;
+    memcpy(&header, file->content, sizeof(header));
+
+    return header.source_hash;
+}
+
+static bool valid_rules(const struct CompiledHeader* const header, const struct CompiledRule* const rules) {
+    for(size_t i = 0; i < (size_t)header->states_size * header->symbol_len; ++i) {
+        if(rules[i].next_state > header->states_size || rules[i].write_symbol >= header->symbol_len || rules[i].direction > STAY) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool valid_tape(const struct CompiledHeader* const header, const Symbol* const tape) {
+    for(size_t i = 0; i < header->tape_len; ++i) {
+        if(tape[i] < 0 || (uint32_t)tape[i] >= header->symbol_len) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Checks that the names consist of exactly one string per symbol and state.
+static bool valid_names(const struct CompiledHeader* const header, const char* const names) {
+    if(header->names_size == 0 || names[header->names_size - 1] != '\0') {
+        return false;
+    }
+
+    size_t amount = 0;
+    for(size_t i = 0; i < header->names_size; ++i) {
+        amount += names[i] == '\0';
+    }
+
+    return amount == (size_t)header->symbol_len + header->states_size;
+}
+
+struct TuringMachine* load_compiled(const struct MappedFile* const file) {
+    if(!is_compiled(file)) {
+        return NULL;
+    }
+
+    struct CompiledHeader header;
+    memcpy(&header, file->content, sizeof(header));
+
+    // Symbols are stored as `short`, so there cannot be more of them.
+    if(header.version != VERSION || header.symbol_len == 0 || header.symbol_len > 1u << 15
+        || header.start > header.states_size || header.blank >= header.symbol_len
+        || header.tape_len == 0 || header.cursor >= header.tape_len) {
+        return NULL;
+    }
+
+    const size_t rules_size = (size_t)header.states_size * header.symbol_len;
+
+    // The sizes are checked one after another so that nothing can overflow.
+    size_t remaining = file->size - sizeof(header);
+    if(rules_size > remaining / sizeof(struct CompiledRule)) {
+        return NULL;
+    }
+    remaining -= rules_size * sizeof(struct CompiledRule);
+
+    if(header.tape_len > remaining / sizeof(Symbol)) {
+        return NULL;
+    }
+    remaining -= header.tape_len * sizeof(Symbol);
+
+    if(header.names_size != remaining) {
+        return NULL;
+    }
+
+    const struct CompiledRule* const compiled_rules = (const struct CompiledRule*)(file->content + sizeof(header));
+    const Symbol* const tape = (const Symbol*)(compiled_rules + rules_size);
+    const char* const compiled_names = (const char*)(tape + header.tape_len);
+
+    if(!valid_rules(&header, compiled_rules) || !valid_tape(&header, tape) || !valid_names(&header, compiled_names)) {
+        return NULL;
+    }
+
+    struct Arena arena = {0};
+
+    struct TuringMachine* machine = arena_alloc(&arena, sizeof(struct TuringMachine));
+    struct State* states = arena_alloc(&arena, sizeof(struct State) * header.states_size);
+    struct Rule* rules = arena_alloc(&arena, sizeof(struct Rule) * rules_size);
+    char** symbol_names = arena_alloc(&arena, sizeof(char*) * header.symbol_len);
+
+    // All names are copied at once and only split up into the strings afterwards.
+    char* names = arena_alloc(&arena, header.names_size);
+    memcpy(names, compiled_names, header.names_size);
+
+    for(size_t i = 0; i < header.symbol_len; ++i) {
+        symbol_names[i] = names;
+        names += strlen(names) + 1;
+    }
+
+    for(size_t i = 0; i < header.states_size; ++i) {
+        states[i].name = names;
+        names += strlen(names) + 1;
+
+        states[i].rules = rules + i * header.symbol_len;
+    }
+
+    for(size_t i = 0; i < rules_size; ++i) {
+        const struct CompiledRule rule = compiled_rules[i];
+
+        rules[i] = (struct Rule){
+            .write_symbol = (Symbol)rule.write_symbol,
+            .direction = (enum Direction)rule.direction,
+            .next_state = rule.next_state == header.states_size ? NULL : &states[rule.next_state]
+        };
+    }
+
+    Symbol* const content = malloc(sizeof(Symbol) * header.tape_len);
+    if(content == NULL) {
+        out_of_memory();
+    }
+    memcpy(content, tape, sizeof(Symbol) * header.tape_len);
+
+    machine->tape = init_tape_full((Symbol)header.blank, content, header.tape_len);
+    machine->tape.cursor = header.cursor;
+    machine->tape.symbol_names = symbol_names;
+    machine->tape.symbol_len = header.symbol_len;
+
+    machine->state = header.start == header.states_size ? NULL : &states[header.start];
+    machine->states = states;
+    machine->states_size = header.states_size;
+
+    machine->arena = arena;
+
+    return machine;
+}
+
+int write_compiled(FILE* const out, const struct TuringMachine* const machine, const uint64_t source_hash) {
+    const struct Tape* const tape = &machine->tape;
+
+    if(machine->states_size >= UINT32_MAX) {
+        return 0;
+    }
+
+    // Only the part of the tape that is not blank (and the head) has to be stored.
+    size_t first = tape->cursor;
+    size_t last = tape->cursor;
+    for(size_t i = 0; i < tape->size; ++i) {
+        if(tape->content[i] != tape->def) {
+            first = i < first ? i : first;
+            last = i > last ? i : last;
+        }
+    }
+
+    size_t names_size = 0;
+    for(size_t i = 0; i < tape->symbol_len; ++i) {
+        names_size += strlen(tape->symbol_names[i]) + 1;
+    }
+    for(size_t i = 0; i < machine->states_size; ++i) {
+        names_size += strlen(machine->states[i].name) + 1;
+    }
+
+    struct CompiledHeader header = {
+        .version = VERSION,
+        .source_hash = source_hash,
+        .symbol_len = (uint32_t)tape->symbol_len,
+        .states_size = (uint32_t)machine->states_size,
+        .start = machine->state == NULL ? (uint32_t)machine->states_size : (uint32_t)(machine->state - machine->states),
+        .blank = (uint32_t)tape->def,
+        .tape_len = last - first + 1,
+        .cursor = tape->cursor - first,
+        .names_size = names_size
+    };
+    memcpy(header.magic, magic, sizeof(magic));
+
+    if(fwrite(&header, sizeof(header), 1, out) != 1) {
+        return 0;
+    }
+
+    for(size_t i = 0; i < machine->states_size; ++i) {
+        for(size_t j = 0; j < tape->symbol_len; ++j) {
+            const struct Rule rule = machine->states[i].rules[j];
+            const struct CompiledRule compiled = {
+                .next_state = rule.next_state == NULL ? (uint32_t)machine->states_size : (uint32_t)(rule.next_state - machine->states),
+                .write_symbol = (uint16_t)rule.write_symbol,
+                .direction = (uint8_t)rule.direction
+            };
+
+            if(fwrite(&compiled, sizeof(compiled), 1, out) != 1) {
+                return 0;
+            }
+        }
+    }
+
+    if(fwrite(tape->content + first, sizeof(Symbol), header.tape_len, out) != header.tape_len) {
+        return 0;
+    }
+
+    for(size_t i = 0; i < tape->symbol_len; ++i) {
+        if(fwrite(tape->symbol_names[i], 1, strlen(tape->symbol_names[i]) + 1, out) == 0) {
+            return 0;
+        }
+    }
+    for(size_t i = 0; i < machine->states_size; ++i) {
+        if(fwrite(machine->states[i].name, 1, strlen(machine->states[i].name) + 1, out) == 0) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "memory.h"
+#include "turingmachine.h"
+
+// The extension of the files that are used as a cache for the sources.
+#define COMPILED_EXTENSION "c"
+
+/* A compiled machine is stored as:
+ *
+ *   | header | rules (states_size * symbol_len) | tape (tape_len) | names |
+ *
+ * The rules are stored state-major with `states_size` as the next state
+ * for the halt state. The names are null terminated strings, first the
+ * symbols and then the states. Everything is stored in the byte order
+ * of the machine that compiled it, as it is only meant as a cache.
+ */
+struct CompiledHeader {
+    char magic[4];
+    uint32_t version;
+
+    // The hash of the source it was compiled from
+    uint64_t source_hash;
+
+    uint32_t symbol_len;
+    uint32_t states_size;
+    // `states_size` if the machine starts halted
+    uint32_t start;
+    uint32_t blank;
+
+    uint64_t tape_len;
+    uint64_t cursor;
+
+    uint64_t names_size;
+};
+
+struct CompiledRule {
+    uint32_t next_state;
+    uint16_t write_symbol;
+    uint8_t direction;
+    uint8_t unused;
+};
+
+bool is_compiled(const struct MappedFile* const file);
+
+uint64_t hash_source(const struct MappedFile* const file);
+
+/* The hash of the source that a compiled file was created from.
+ * It should only be used if the file is compiled.
+ */
+uint64_t compiled_source_hash(const struct MappedFile* const file);
+
+/* Creates the machine out of a compiled file without parsing
+ * anything. The file is not needed afterwards.
+ *
+ * @return The machine or NULL if the file is not a valid compiled machine.
+ */
+struct TuringMachine* load_compiled(const struct MappedFile* const file);
+
+/* Writes the machine in its current configuration.
+ *
+ * @return 1 if it was successful and 0 otherwise.
+ */
+int write_compiled(FILE* const out, const struct TuringMachine* const machine, const uint64_t source_hash);
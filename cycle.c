@@ -0,0 +1,266 @@
+#include "cycle.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "memory.h"
+
+// A configuration that the following ones are compared to.
+struct Snapshot {
+    size_t step;
+    StateId state;
+    long position;
+    uint64_t hash;
+
+    // The cells from `low` to `high`
+    long low;
+    long high;
+    Symbol* cells;
+    size_t allocated;
+
+    size_t limit;
+};
+
+/* The configuration when the head moved further than ever before to one side.
+ * All of the cells in front of the head are blank at this point.
+ */
+struct Record {
+    bool valid;
+    size_t step;
+    StateId state;
+    long position;
+
+    // The cell the furthest away from the front that the head visited since the record
+    long back;
+
+    // The cells from the head to the other end of the used part of the tape
+    Symbol* cells;
+    size_t size;
+    size_t allocated;
+
+    // The records since this one and how many there can be until it is replaced
+    size_t seen;
+    size_t limit;
+};
+
+static Symbol* reserve_cells(Symbol* cells, size_t* const allocated, const size_t size) {
+    if(size <= *allocated) {
+        return cells;
+    }
+
+    cells = realloc(cells, sizeof(Symbol) * size);
+    if(cells == NULL) {
+        out_of_memory();
+    }
+
+    *allocated = size;
+    return cells;
+}
+
+// The hash of a cell, where blank cells do not change the hash of the tape (Zobrist hashing).
+static uint64_t cell_hash(const long position, const Symbol symbol, const Symbol def) {
+    if(symbol == def) {
+        return 0;
+    }
+
+    // The finalizer of splitmix64
+    uint64_t x = (uint64_t)position * 0x9E3779B97F4A7C15ull + (uint64_t)symbol;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+// The cell at `target` while the head is at `position`.
+static Symbol cell_at(const struct Tape* const tape, const long position, const long target) {
+    const long index = (long)tape->cursor + (target - position);
+
+    return index < 0 || index >= (long)tape->size ? tape->def : tape->content[index];
+}
+
+static void take_snapshot(struct Snapshot* const snapshot, const struct Tape* const tape, const size_t step, const StateId state, const long position, const uint64_t hash, const long low, const long high) {
+    snapshot->step = step;
+    snapshot->state = state;
+    snapshot->position = position;
+    snapshot->hash = hash;
+    snapshot->low = low;
+    snapshot->high = high;
+
+    snapshot->cells = reserve_cells(snapshot->cells, &snapshot->allocated, high - low + 1);
+    for(long i = low; i <= high; ++i) {
+        snapshot->cells[i - low] = cell_at(tape, position, i);
+    }
+}
+
+// Only called if the state, the head and the hash are the same.
+static bool same_tape(const struct Snapshot* const snapshot, const struct Tape* const tape, const long position, const long low, const long high) {
+    const long from = low < snapshot->low ? low : snapshot->low;
+    const long to = high > snapshot->high ? high : snapshot->high;
+
+    for(long i = from; i <= to; ++i) {
+        const Symbol saved = i < snapshot->low || i > snapshot->high ? tape->def : snapshot->cells[i - snapshot->low];
+
+        if(saved != cell_at(tape, position, i)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* Saves the record with the cells from the head to `end`.
+ * `side` is 1 for records on the right and -1 for records on the left.
+ */
+static void take_record(struct Record* const record, const struct Tape* const tape, const size_t step, const StateId state, const long position, const long end, const long side) {
+    record->step = step;
+    record->state = state;
+    record->position = position;
+    record->back = position;
+
+    record->size = side * (position - end) + 1;
+    record->cells = reserve_cells(record->cells, &record->allocated, record->size);
+    for(size_t i = 0; i < record->size; ++i) {
+        record->cells[i] = cell_at(tape, position, position - side * (long)i);
+    }
+
+    record->seen = 0;
+    record->limit = record->valid ? record->limit * 2 : 1;
+    record->valid = true;
+}
+
+// Whether the cells behind the head are the same as the ones of the record that were visited since then.
+static bool same_record(const struct Record* const record, const struct Tape* const tape, const long position, const long side) {
+    const size_t visited = side * (record->position - record->back) + 1;
+
+    for(size_t i = 0; i < visited; ++i) {
+        const Symbol saved = i < record->size ? record->cells[i] : tape->def;
+
+        if(saved != cell_at(tape, position, position - side * (long)i)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* Handles a new record on one side.
+ *
+ * @return Whether the record proves a cycle.
+ */
+static bool check_record(struct Record* const record, const struct Tape* const tape, const size_t step, const StateId state, const long position, const long end, const long side, struct Cycle* const cycle) {
+    if(record->valid && record->state == state && same_record(record, tape, position, side)) {
+        cycle->start = record->step;
+        cycle->period = step - record->step;
+        cycle->shift = position - record->position;
+        return true;
+    }
+
+    if(!record->valid || ++record->seen >= record->limit) {
+        take_record(record, tape, step, state, position, end, side);
+    }
+
+    return false;
+}
+
+size_t run_table_cycles(const struct TransitionTable* const table, struct Tape* const tape, StateId* const state, const size_t max_iter, struct Cycle* const cycle) {
+    const PackedRule* const rules = table->rules;
+    const size_t symbol_len = table->symbol_len;
+    const StateId halt = table->halt;
+    const Symbol def = tape->def;
+
+    StateId current = *state;
+    size_t count = 0;
+
+    // The positions are relative to the head at the start and
+    // the used part of the tape only contains the head at first.
+    long position = 0;
+    long low = 0;
+    long high = 0;
+
+    uint64_t hash = 0;
+    for(size_t i = 0; i < tape->size; ++i) {
+        if(tape->content[i] != def) {
+            const long cell = (long)i - (long)tape->cursor;
+
+            low = cell < low ? cell : low;
+            high = cell > high ? cell : high;
+            hash ^= cell_hash(cell, tape->content[i], def);
+        }
+    }
+
+    *cycle = (struct Cycle){0};
+
+    struct Snapshot snapshot = {.limit = 1};
+    struct Record right_record = {0};
+    struct Record left_record = {0};
+
+    take_snapshot(&snapshot, tape, count, current, position, hash, low, high);
+
+    while(current != halt && count < max_iter) {
+        const Symbol symbol = tape->content[tape->cursor];
+        const PackedRule rule = rules[current * symbol_len + symbol];
+        const Symbol write = RULE_SYMBOL(table, rule);
+
+        if(write != symbol) {
+            hash ^= cell_hash(position, symbol, def) ^ cell_hash(position, write, def);
+            tape->content[tape->cursor] = write;
+        }
+
+        switch(RULE_DIRECTION(table, rule)) {
+        case RIGHT:
+            right(tape);
+            ++position;
+            break;
+        case LEFT:
+            left(tape);
+            --position;
+            break;
+        case STAY:
+            // Do nothing
+            break;
+        }
+
+        current = RULE_NEXT(table, rule);
+        ++count;
+
+        if(current == halt) {
+            break;
+        }
+
+        // The furthest the head went back since the records
+        right_record.back = position < right_record.back ? position : right_record.back;
+        left_record.back = position > left_record.back ? position : left_record.back;
+
+        if(position > high) {
+            high = position;
+            if(check_record(&right_record, tape, count, current, position, low, 1, cycle)) {
+                break;
+            }
+        } else if(position < low) {
+            low = position;
+            if(check_record(&left_record, tape, count, current, position, high, -1, cycle)) {
+                break;
+            }
+        }
+
+        if(hash == snapshot.hash && current == snapshot.state && position == snapshot.position && same_tape(&snapshot, tape, position, low, high)) {
+            cycle->start = snapshot.step;
+            cycle->period = count - snapshot.step;
+            cycle->shift = 0;
+            break;
+        }
+
+        if(count - snapshot.step >= snapshot.limit) {
+            take_snapshot(&snapshot, tape, count, current, position, hash, low, high);
+            snapshot.limit *= 2;
+        }
+    }
+
+    free(snapshot.cells);
+    free(right_record.cells);
+    free(left_record.cells);
+
+    *state = current;
+
+    return count;
+}
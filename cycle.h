@@ -0,0 +1,30 @@
+#pragma once
+
+#include "table.h"
+
+/* A proof that a Turing Machine never halts: From the step `start` on,
+ * the configuration repeats every `period` steps and is moved by `shift`
+ * cells (to the right if it is positive) each time.
+ * If nothing was found, `period` is 0.
+ */
+struct Cycle {
+    size_t start;
+    size_t period;
+    long shift;
+};
+
+/* Runs the table on the tape like `run_table`, but also looks for cycles:
+ *
+ * - The configuration (state, head and tape) is hashed incrementally in every step
+ *   and compared to a configuration that is saved at steps that double
+ *   in distance (Brent). If the hashes are equal, the tapes are compared.
+ * - Every time the head moves further to the right/left than ever before, the
+ *   state and the cells behind the head are compared to a saved record of the same
+ *   side. If they are equal for all of the cells the head visited in between,
+ *   the machine repeats the same steps shifted by the distance forever.
+ *
+ * The run stops as soon as a cycle is found.
+ *
+ * @return The amount of steps that were executed.
+ */
+size_t run_table_cycles(const struct TransitionTable* const table, struct Tape* const tape, StateId* const state, const size_t max_iter, struct Cycle* const cycle);
@@ -0,0 +1,193 @@
+#include "decide.h"
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "memory.h"
+
+static void* allocate(const size_t size) {
+    void* const memory = calloc(size > 0 ? size : 1, 1);
+    if(memory == NULL) {
+        out_of_memory();
+    }
+
+    return memory;
+}
+
+/* The states and symbols that were found, but whose rules are not checked yet.
+ * Every combination of a state and a symbol is checked exactly once: When the
+ * second of the two is taken from its queue.
+ */
+struct Reachable {
+    const struct State* states;
+
+    bool* state_seen;
+    size_t* state_queue;
+    size_t states_pushed;
+    size_t states_done;
+
+    bool* symbol_seen;
+    Symbol* symbol_queue;
+    size_t symbols_pushed;
+    size_t symbols_done;
+};
+
+static void push_state(struct Reachable* const reachable, const struct State* const state) {
+    const size_t index = state - reachable->states;
+
+    if(!reachable->state_seen[index]) {
+        reachable->state_seen[index] = true;
+        reachable->state_queue[reachable->states_pushed++] = index;
+    }
+}
+
+static void push_symbol(struct Reachable* const reachable, const Symbol symbol) {
+    if(!reachable->symbol_seen[symbol]) {
+        reachable->symbol_seen[symbol] = true;
+        reachable->symbol_queue[reachable->symbols_pushed++] = symbol;
+    }
+}
+
+/* Adds what the rule of the state for the symbol can lead to.
+ *
+ * @return 0 if the rule halts and 1 otherwise.
+ */
+static int visit(struct Reachable* const reachable, const size_t state, const Symbol symbol) {
+    const struct Rule rule = reachable->states[state].rules[symbol];
+
+    if(rule.next_state == NULL) {
+        return 0;
+    }
+
+    push_symbol(reachable, rule.write_symbol);
+    push_state(reachable, rule.next_state);
+    return 1;
+}
+
+static bool halt_unreachable(const struct TuringMachine* const machine) {
+    const struct Tape* const tape = &machine->tape;
+
+    struct Reachable reachable = {
+        .states = machine->states,
+        .state_seen = allocate(sizeof(bool) * machine->states_size),
+        .state_queue = allocate(sizeof(size_t) * machine->states_size),
+        .symbol_seen = allocate(sizeof(bool) * tape->symbol_len),
+        .symbol_queue = allocate(sizeof(Symbol) * tape->symbol_len)
+    };
+
+    push_state(&reachable, machine->state);
+    push_symbol(&reachable, tape->def);
+    for(size_t i = 0; i < tape->size; ++i) {
+        push_symbol(&reachable, tape->content[i]);
+    }
+
+    bool unreachable = true;
+
+    while(unreachable && (reachable.states_done < reachable.states_pushed || reachable.symbols_done < reachable.symbols_pushed)) {
+        if(reachable.states_done < reachable.states_pushed) {
+            // The new state with all of the symbols that were already checked
+            const size_t state = reachable.state_queue[reachable.states_done++];
+
+            for(size_t i = 0; i < reachable.symbols_done && unreachable; ++i) {
+                unreachable = visit(&reachable, state, reachable.symbol_queue[i]);
+            }
+        } else {
+            const Symbol symbol = reachable.symbol_queue[reachable.symbols_done++];
+
+            for(size_t i = 0; i < reachable.states_done && unreachable; ++i) {
+                unreachable = visit(&reachable, reachable.state_queue[i], symbol);
+            }
+        }
+    }
+
+    free(reachable.state_seen);
+    free(reachable.state_queue);
+    free(reachable.symbol_seen);
+    free(reachable.symbol_queue);
+
+    return unreachable;
+}
+
+/* Follows the machine as long as the head only moves in `direction` (or stays),
+ * so that every cell it moves onto still has its initial content.
+ */
+static bool one_direction(const struct TuringMachine* const machine, const enum Direction direction) {
+    const struct Tape* const tape = &machine->tape;
+    const size_t pairs = machine->states_size * tape->symbol_len;
+
+    // Where each combination of a state and a symbol was last seen.
+    // All of the cells beyond the initial tape count as the same one (LONG_MAX).
+    long* const seen = allocate(sizeof(long) * pairs);
+    for(size_t i = 0; i < pairs; ++i) {
+        seen[i] = LONG_MIN;
+    }
+
+    const struct State* state = machine->state;
+    long position = (long)tape->cursor;
+    Symbol cell = tape->content[tape->cursor];
+    bool result = false;
+
+    while(true) {
+        const bool beyond = position < 0 || position >= (long)tape->size;
+        const size_t pair = (state - machine->states) * tape->symbol_len + cell;
+
+        // On the blanks the same combination repeats everything since it was seen.
+        // On the initial tape it can only repeat by staying on the same cell.
+        const long stamp = beyond ? LONG_MAX : position;
+        if(seen[pair] == stamp) {
+            result = true;
+            break;
+        }
+        seen[pair] = stamp;
+
+        const struct Rule rule = state->rules[cell];
+        if(rule.next_state == NULL || (rule.direction != direction && rule.direction != STAY)) {
+            break;
+        }
+
+        state = rule.next_state;
+
+        if(rule.direction == STAY) {
+            cell = rule.write_symbol;
+            continue;
+        }
+
+        position += direction == RIGHT ? 1 : -1;
+        cell = position < 0 || position >= (long)tape->size ? tape->def : tape->content[position];
+    }
+
+    free(seen);
+
+    return result;
+}
+
+enum Verdict decide(const struct TuringMachine* const machine) {
+    // A machine without a start state halts immediately.
+    if(machine->state == NULL) {
+        return VERDICT_UNKNOWN;
+    }
+
+    if(halt_unreachable(machine)) {
+        return VERDICT_UNREACHABLE_HALT;
+    }
+
+    if(one_direction(machine, RIGHT) || one_direction(machine, LEFT)) {
+        return VERDICT_ONE_DIRECTION;
+    }
+
+    return VERDICT_UNKNOWN;
+}
+
+const char* verdict_reason(const enum Verdict verdict) {
+    switch(verdict) {
+    case VERDICT_UNREACHABLE_HALT:
+        return "None of the rules that halt can be reached.";
+    case VERDICT_ONE_DIRECTION:
+        return "The head only moves in one direction and repeats the same states on blanks.";
+    case VERDICT_UNKNOWN:
+        break;
+    }
+
+    return "Nothing could be proven.";
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "turingmachine.h"
+
+enum Verdict {
+    // None of the deciders could prove anything.
+    VERDICT_UNKNOWN,
+    // No rule that leads to the halt state can ever be used.
+    VERDICT_UNREACHABLE_HALT,
+    // The head only moves in one direction and runs through the same states on blanks forever.
+    VERDICT_ONE_DIRECTION
+};
+
+/* Tries to prove that the machine never halts from its states
+ * and the initial tape alone, without running it:
+ *
+ * - The states that can be reached and the symbols that can be on the tape are
+ *   collected together until nothing changes. If none of their rules halts,
+ *   the machine never halts.
+ * - If the head only ever moves in one direction, it only reads the initial tape
+ *   and then blanks. Once it is beyond the initial tape, the same states have to
+ *   repeat, which only takes as many steps as there are states and symbols.
+ *
+ * @return The reason why the machine never halts or VERDICT_UNKNOWN.
+ */
+enum Verdict decide(const struct TuringMachine* const machine);
+
+// A sentence that explains the verdict.
+const char* verdict_reason(const enum Verdict verdict);
@@ -0,0 +1,223 @@
+#include "emit.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "memory.h"
+
+static void emit_header(FILE* const out, const struct TuringMachine* const machine, const char* const source, const size_t max_iter, const size_t view_width) {
+    const struct Tape* const tape = &machine->tape;
+
+    fprintf(out, "/* Generated by tau from %s */\n\n", source);
+    fprintf(out,
+        "#include <stdio.h>\n"
+        "#include <stdlib.h>\n"
+        "#include <string.h>\n\n"
+        "typedef short Symbol;\n\n"
+    );
+
+    fprintf(out, "static const char* const symbol_names[] = {");
+    for(size_t i = 0; i < tape->symbol_len; ++i) {
+        fprintf(out, "%s\"%s\"", i == 0 ? "" : ", ", tape->symbol_names[i]);
+    }
+    fprintf(out, "};\n\n");
+
+    fprintf(out, "static const char* const state_names[] = {");
+    for(size_t i = 0; i < machine->states_size; ++i) {
+        fprintf(out, "%s\"%s\"", i == 0 ? "" : ", ", machine->states[i].name);
+    }
+    fprintf(out, "%s\"HALT\"};\n\n", machine->states_size == 0 ? "" : ", ");
+
+    // Only the part of the tape that is not blank has to be stored.
+    size_t start = tape->cursor;
+    size_t end = tape->cursor + 1;
+    for(size_t i = 0; i < tape->size; ++i) {
+        if(tape->content[i] != tape->def) {
+            start = i < start ? i : start;
+            end = i + 1 > end ? i + 1 : end;
+        }
+    }
+
+    fprintf(out, "static const Symbol initial[] = {");
+    for(size_t i = start; i < end; ++i) {
+        fprintf(out, "%s%d", i == start ? "" : ", ", tape->content[i]);
+    }
+    fprintf(out, "};\n\n");
+
+    fprintf(out,
+        "#define BLANK %d\n"
+        "#define INITIAL_CURSOR %zu\n"
+        "#define MAX_ITER %zuull\n"
+        "#define VIEW_WIDTH %zu\n\n",
+        tape->def, tape->cursor - start, max_iter, view_width
+    );
+}
+
+static void emit_tape(FILE* const out) {
+    fprintf(out,
+        "static Symbol* tape;\n"
+        "static size_t size;\n\n"
+        "static inline void grow_left(size_t* const cursor) {\n"
+        "    Symbol* new = malloc(sizeof(Symbol) * size * 2);\n"
+        "    if(new == NULL) {\n"
+        "        fprintf(stderr, \"Not enough memory\\n\");\n"
+        "        exit(EXIT_FAILURE);\n"
+        "    }\n\n"
+        "    memcpy(new + size, tape, sizeof(Symbol) * size);\n"
+        "    for(size_t i = 0; i < size; ++i) {\n"
+        "        new[i] = BLANK;\n"
+        "    }\n\n"
+        "    free(tape);\n"
+        "    tape = new;\n"
+        "    *cursor += size;\n"
+        "    size *= 2;\n"
+        "}\n\n"
+        "static inline void grow_right(void) {\n"
+        "    Symbol* new = realloc(tape, sizeof(Symbol) * size * 2);\n"
+        "    if(new == NULL) {\n"
+        "        fprintf(stderr, \"Not enough memory\\n\");\n"
+        "        exit(EXIT_FAILURE);\n"
+        "    }\n\n"
+        "    for(size_t i = size; i < size * 2; ++i) {\n"
+        "        new[i] = BLANK;\n"
+        "    }\n\n"
+        "    tape = new;\n"
+        "    size *= 2;\n"
+        "}\n\n"
+        "#define LEFT() if(cursor-- == 0) { grow_left(&cursor); }\n"
+        "#define RIGHT() if(++cursor == size) { grow_right(); }\n\n"
+        "static void print_result(const size_t state, const size_t cursor, const unsigned long long steps) {\n"
+        "    printf(\"State: %%s\\n\", state_names[state]);\n\n"
+        "    const long top = (long)cursor + VIEW_WIDTH / 2 + VIEW_WIDTH %% 2;\n"
+        "    printf(\"..., \");\n"
+        "    for(long i = (long)cursor - VIEW_WIDTH / 2; i < top; ++i) {\n"
+        "        const Symbol symbol = i < 0 || i >= (long)size ? BLANK : tape[i];\n"
+        "        printf(i == (long)cursor ? \"\\033[31m%%s\\033[0m, \" : \"%%s, \", symbol_names[symbol]);\n"
+        "    }\n"
+        "    printf(\"...\\n\");\n\n"
+        "    printf(\"Steps: %%llu\\n\", steps);\n"
+        "}\n\n"
+    );
+}
+
+static const char* const moves[] = {
+    [LEFT] = "LEFT(); ",
+    [RIGHT] = "RIGHT(); ",
+    [STAY] = ""
+};
+
+static void emit_states(FILE* const out, const struct TuringMachine* const machine) {
+    const size_t halt = machine->states_size;
+    const size_t start = machine->state == NULL ? halt : (size_t)(machine->state - machine->states);
+
+    fprintf(out,
+        "int main(const int argc, const char** const argv) {\n"
+        "    const unsigned long long max_iter = argc > 1 ? strtoull(argv[1], NULL, 10) : MAX_ITER;\n\n"
+        "    size = sizeof(initial) / sizeof(Symbol) * 2 + 16;\n"
+        "    tape = malloc(sizeof(Symbol) * size);\n"
+        "    if(tape == NULL) {\n"
+        "        fprintf(stderr, \"Not enough memory\\n\");\n"
+        "        return EXIT_FAILURE;\n"
+        "    }\n\n"
+        "    for(size_t i = 0; i < size; ++i) {\n"
+        "        tape[i] = BLANK;\n"
+        "    }\n"
+        "    memcpy(tape + 8, initial, sizeof(initial));\n\n"
+        "    size_t cursor = INITIAL_CURSOR + 8;\n"
+        "    unsigned long long steps = 0;\n"
+        "    size_t state = %zu;\n\n"
+        "    goto state_%zu;\n\n",
+        start, start
+    );
+
+    // Only the states that can be reached from the start are emitted as
+    // the compiler would complain about the unused labels.
+    bool* const used = calloc(halt + 1, sizeof(bool));
+    size_t* const stack = malloc(sizeof(size_t) * (halt + 1));
+    if(used == NULL || stack == NULL) {
+        out_of_memory();
+    }
+
+    size_t stack_size = 0;
+    used[start] = true;
+    stack[stack_size++] = start;
+
+    while(stack_size > 0) {
+        const size_t i = stack[--stack_size];
+        if(i == halt) {
+            continue;
+        }
+
+        for(size_t j = 0; j < machine->tape.symbol_len; ++j) {
+            const struct State* const next_state = machine->states[i].rules[j].next_state;
+            const size_t next = next_state == NULL ? halt : (size_t)(next_state - machine->states);
+
+            if(!used[next]) {
+                used[next] = true;
+                stack[stack_size++] = next;
+            }
+        }
+    }
+
+    free(stack);
+
+    for(size_t i = 0; i < machine->states_size; ++i) {
+        const struct State* const state = &machine->states[i];
+
+        if(!used[i]) {
+            continue;
+        }
+
+        fprintf(out,
+            "state_%zu: // %s\n"
+            "    if(steps == max_iter) {\n"
+            "        state = %zu;\n"
+            "        goto limit;\n"
+            "    }\n"
+            "    ++steps;\n\n"
+            "    switch(tape[cursor]) {\n",
+            i, state->name, i
+        );
+
+        for(size_t j = 0; j < machine->tape.symbol_len; ++j) {
+            const struct Rule rule = state->rules[j];
+            const size_t next = rule.next_state == NULL ? halt : (size_t)(rule.next_state - machine->states);
+
+            fprintf(out, "    case %zu: ", j);
+
+            // Writing the same symbol again can be skipped.
+            if(rule.write_symbol != (Symbol)j) {
+                fprintf(out, "tape[cursor] = %d; ", rule.write_symbol);
+            }
+
+            fprintf(out, "%sgoto state_%zu;\n", moves[rule.direction], next);
+        }
+
+        fprintf(out, "    }\n\n");
+    }
+
+    if(used[halt]) {
+        fprintf(out,
+            "state_%zu: // HALT\n"
+            "    print_result(%zu, cursor, steps);\n"
+            "    return 0;\n\n",
+            halt, halt
+        );
+    }
+
+    free(used);
+
+    fprintf(out,
+        "limit:\n"
+        "    print_result(state, cursor, steps);\n"
+        "    fprintf(stderr, \"Error: Maximum iterations reached: %%llu. Stopping.\\n\", max_iter);\n"
+        "    return 2;\n"
+        "}\n"
+    );
+}
+
+void emit_c(FILE* const out, const struct TuringMachine* const machine, const char* const source, const size_t max_iter, const size_t view_width) {
+    emit_header(out, machine, source, max_iter, view_width);
+    emit_tape(out);
+    emit_states(out, machine);
+}
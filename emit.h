@@ -0,0 +1,14 @@
+#pragma once
+
+#include <stdio.h>
+
+#include "turingmachine.h"
+
+/* Writes a standalone C program that runs the machine.
+ * Every state becomes a label and every rule a direct jump,
+ * so the program does not need to look anything up while running.
+ *
+ * The program takes the maximum amount of iterations as an optional
+ * argument and uses `max_iter` by default.
+ */
+void emit_c(FILE* const out, const struct TuringMachine* const machine, const char* const source, const size_t max_iter, const size_t view_width);
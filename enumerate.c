@@ -0,0 +1,909 @@
+#include "enumerate.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "arena.h"
+#include "cycle.h"
+#include "decide.h"
+#include "lockstep.h"
+#include "memory.h"
+#include "pool.h"
+#include "table.h"
+
+// The states are written as letters and the symbols as digits.
+#define MAX_STATES 26
+#define MAX_SYMBOLS 10
+
+// The top of the tree is expanded on a single thread until there are enough subtrees for the pool.
+#define FRONTIER_SIZE 4096
+
+// Most machines that never halt loop after a few steps, so they are checked after this
+// many steps (since their parent) instead of being run to the end of the budget first.
+#define PROBE_STEPS 256
+
+// The machines for the lockstep engine are only checked for cycles for this many steps from
+// the start (or up to the probe), as the engine runs the rest of the budget without it.
+#define CYCLE_STEPS 1024
+
+// The machines a search collects for the lockstep engine before it runs them.
+#define LOCKSTEP_BATCH 1024
+
+// The head is at `origin + head` of the cells and only the cells from `low` to `high` can be non-blank.
+struct Configuration {
+    StateId state;
+    size_t steps;
+    long head;
+    long low;
+    long high;
+};
+
+// The configuration (and its cells) where a machine reached the transition that its children define.
+struct Snapshot {
+    struct Configuration configuration;
+    uint8_t* cells;
+    size_t allocated;
+};
+
+struct Node {
+    // The amount of defined transitions (which is also the depth in the tree)
+    size_t defined;
+    // The amount of states and symbols that are used, the start state and the blank included
+    size_t states;
+    size_t symbols;
+};
+
+struct Child {
+    Symbol write;
+    enum Direction direction;
+    StateId next;
+};
+
+// A subtree for the pool
+struct Prefix {
+    PackedRule* rules;
+    struct Node node;
+};
+
+struct Champion {
+    char* machine;
+    // The amount of non-blank cells after it halted
+    size_t cells;
+};
+
+struct Tally {
+    size_t halted;
+    size_t looped;
+    size_t undecided;
+
+    // The steps of the champions
+    size_t best;
+    struct Champion* champions;
+    size_t champions_size;
+    size_t champions_allocated;
+};
+
+struct Enumeration;
+
+// Everything a thread needs to search its subtrees.
+struct Search {
+    bool ready;
+    const struct Enumeration* enumeration;
+
+    // The machine that is being built. Undefined transitions have no next state, so that they halt.
+    struct TuringMachine machine;
+    Symbol blank;
+    struct TransitionTable table;
+
+    uint8_t* cells;
+    size_t size;
+    size_t origin;
+    struct Configuration configuration;
+
+    // One for each depth of the tree
+    struct Snapshot* snapshots;
+
+    struct Tally tally;
+
+    // The machines that were still running after the probe and the short cycle detection.
+    // They are run to the end of the budget together by the lockstep engine once there
+    // are enough of them (if they only have two symbols).
+    bool lockstep;
+    PackedRule* pending;
+    struct Node* pending_nodes;
+    size_t pending_size;
+    size_t pending_allocated;
+
+    // The undecided machines in the compact notation, if they are kept
+    char** undecided;
+    size_t undecided_size;
+    size_t undecided_allocated;
+};
+
+struct Enumeration {
+    size_t states;
+    size_t symbols;
+    size_t max_iter;
+    bool keep_undecided;
+
+    struct Prefix* prefixes;
+    size_t size;
+
+    struct Search* searches;
+};
+
+static void* allocate(const size_t size) {
+    void* const memory = calloc(size > 0 ? size : 1, 1);
+    if(memory == NULL) {
+        out_of_memory();
+    }
+
+    return memory;
+}
+
+static PackedRule pack_rule(const struct TransitionTable* const table, const Symbol write, const enum Direction direction, const StateId next) {
+    return (PackedRule)next << (table->symbol_bits + 2)
+         | (PackedRule)direction << table->symbol_bits
+         | (PackedRule)write;
+}
+
+// Sets a transition in both the states and the table (`next` is the halt state to remove it).
+static void define(struct Search* const search, const size_t state, const Symbol symbol, const PackedRule rule) {
+    const struct TransitionTable* const table = &search->table;
+    const StateId next = RULE_NEXT(table, rule);
+
+    search->table.rules[state * table->symbol_len + symbol] = rule;
+
+    if(next == table->halt) {
+        search->machine.states[state].rules[symbol] = (struct Rule){0};
+    } else {
+        search->machine.states[state].rules[symbol] = (struct Rule){
+            .write_symbol = RULE_SYMBOL(table, rule),
+            .direction = RULE_DIRECTION(table, rule),
+            .next_state = &search->machine.states[next]
+        };
+    }
+}
+
+static void init_search(struct Search* const search, const struct Enumeration* const enumeration) {
+    const size_t states_size = enumeration->states;
+    const size_t symbol_len = enumeration->symbols;
+
+    struct State* const states = allocate(sizeof(struct State) * states_size);
+    struct Rule* const rules = allocate(sizeof(struct Rule) * states_size * symbol_len);
+    for(size_t i = 0; i < states_size; ++i) {
+        states[i].rules = rules + i * symbol_len;
+    }
+
+    *search = (struct Search){
+        .ready = true,
+        .enumeration = enumeration,
+        .machine = {
+            .state = states,
+            .states = states,
+            .states_size = states_size
+        },
+        .size = 1024,
+        .origin = 512,
+        .snapshots = allocate(sizeof(struct Snapshot) * states_size * symbol_len),
+        .cells = allocate(1024)
+    };
+
+    // The deciders only look at the blank tape the machine starts on.
+    search->machine.tape = (struct Tape){
+        .content = &search->blank,
+        .size = 1,
+        .symbol_len = symbol_len
+    };
+
+    // The table only changes in single rules, so it is not worth keeping a narrow copy in sync.
+    compile_table(&search->table, &search->machine);
+    free(search->table.narrow_rules);
+    search->table.narrow_rules = NULL;
+
+    search->lockstep = lockstep_supported(&search->table);
+}
+
+static void free_search(struct Search* const search) {
+    const size_t depth = search->enumeration->states * search->enumeration->symbols;
+
+    for(size_t i = 0; i < depth; ++i) {
+        free(search->snapshots[i].cells);
+    }
+    for(size_t i = 0; i < search->tally.champions_size; ++i) {
+        free(search->tally.champions[i].machine);
+    }
+
+    free(search->machine.states[0].rules);
+    free(search->machine.states);
+    free_table(&search->table);
+    free(search->cells);
+    free(search->snapshots);
+    free(search->tally.champions);
+    free(search->pending);
+    free(search->pending_nodes);
+    free(search->undecided);
+}
+
+/* Doubles the cells with the old ones in the middle.
+ *
+ * @return The new index of the head.
+ */
+static size_t grow_cells(struct Search* const search, const size_t index) {
+    const size_t offset = search->size / 2;
+    uint8_t* const cells = allocate(search->size * 2);
+
+    memcpy(cells + offset, search->cells, search->size);
+    free(search->cells);
+
+    search->cells = cells;
+    search->size *= 2;
+    search->origin += offset;
+
+    return index + offset;
+}
+
+/* Runs the machine from its configuration until it reaches a transition
+ * that is not defined yet or it did `limit` steps in total.
+ *
+ * @return true if it reached an undefined transition.
+ */
+static bool run_search(struct Search* const search, const size_t limit) {
+    // Everything that is needed in the loop is kept in locals
+    // so that the compiler can keep them in registers.
+    const struct TransitionTable* const table = &search->table;
+    const PackedRule* const rules = table->rules;
+    const size_t symbol_len = table->symbol_len;
+    const StateId halt = table->halt;
+    struct Configuration* const configuration = &search->configuration;
+
+    const size_t budget = limit - configuration->steps;
+    uint8_t* cells = search->cells;
+    size_t index = search->origin + configuration->head;
+    StateId state = configuration->state;
+    size_t count = 0;
+    bool reached = false;
+
+    while(count < budget) {
+        const PackedRule rule = rules[state * symbol_len + cells[index]];
+        const StateId next = RULE_NEXT(table, rule);
+
+        if(next == halt) {
+            reached = true;
+            break;
+        }
+
+        cells[index] = (uint8_t)RULE_SYMBOL(table, rule);
+
+        // The enumerated machines never stay.
+        if(RULE_DIRECTION(table, rule) == RIGHT) {
+            if(++index == search->size) {
+                index = grow_cells(search, index);
+                cells = search->cells;
+            }
+        } else {
+            if(index == 0) {
+                index = grow_cells(search, index);
+                cells = search->cells;
+            }
+            --index;
+        }
+
+        state = next;
+        ++count;
+    }
+
+    // Every step can only change the cells within reach of where the head started.
+    const long start = configuration->head;
+    const long first = -(long)search->origin;
+    const long last = (long)(search->size - search->origin) - 1;
+
+    configuration->head = (long)index - (long)search->origin;
+    configuration->state = state;
+    configuration->steps += count;
+    configuration->low = start - (long)count < configuration->low ? start - (long)count : configuration->low;
+    configuration->high = start + (long)count > configuration->high ? start + (long)count : configuration->high;
+    configuration->low = configuration->low < first ? first : configuration->low;
+    configuration->high = configuration->high > last ? last : configuration->high;
+
+    return reached;
+}
+
+static void save_snapshot(struct Search* const search, const size_t depth) {
+    struct Snapshot* const snapshot = &search->snapshots[depth];
+    const struct Configuration* const configuration = &search->configuration;
+    const size_t length = configuration->high - configuration->low + 1;
+
+    if(length > snapshot->allocated) {
+        free(snapshot->cells);
+        snapshot->cells = allocate(length);
+        snapshot->allocated = length;
+    }
+
+    memcpy(snapshot->cells, search->cells + search->origin + configuration->low, length);
+    snapshot->configuration = *configuration;
+}
+
+static void restore_snapshot(struct Search* const search, const size_t depth) {
+    const struct Snapshot* const snapshot = &search->snapshots[depth];
+    struct Configuration* const configuration = &search->configuration;
+
+    memset(search->cells + search->origin + configuration->low, 0, configuration->high - configuration->low + 1);
+
+    *configuration = snapshot->configuration;
+    memcpy(search->cells + search->origin + configuration->low, snapshot->cells, configuration->high - configuration->low + 1);
+}
+
+// Starts the machine of the prefix on a blank tape.
+static void load_prefix(struct Search* const search, const struct Prefix* const prefix) {
+    const size_t symbol_len = search->enumeration->symbols;
+
+    for(size_t i = 0; i < search->enumeration->states; ++i) {
+        for(size_t j = 0; j < symbol_len; ++j) {
+            define(search, i, j, prefix->rules[i * symbol_len + j]);
+        }
+    }
+
+    struct Configuration* const configuration = &search->configuration;
+    memset(search->cells + search->origin + configuration->low, 0, configuration->high - configuration->low + 1);
+
+    *configuration = (struct Configuration){
+        .state = search->table.start
+    };
+}
+
+/* Writes the machine in the compact notation with `1RZ` for the transition
+ * from `halt_state` on `halt_symbol` (if it is a state) and `---` for the others
+ * that are not defined.
+ *
+ * @return The notation, which has to be freed.
+ */
+static char* notation(const struct Search* const search, const size_t halt_state, const Symbol halt_symbol) {
+    const size_t states_size = search->enumeration->states;
+    const size_t symbol_len = search->enumeration->symbols;
+    char* const text = allocate(states_size * (symbol_len * 3 + 1));
+
+    char* out = text;
+    for(size_t i = 0; i < states_size; ++i) {
+        if(i > 0) {
+            *out++ = '_';
+        }
+
+        for(size_t j = 0; j < symbol_len; ++j) {
+            const struct Rule rule = search->machine.states[i].rules[j];
+
+            if(rule.next_state != NULL) {
+                *out++ = (char)('0' + rule.write_symbol);
+                *out++ = rule.direction == LEFT ? 'L' : 'R';
+                *out++ = (char)('A' + (rule.next_state - search->machine.states));
+            } else if(i == halt_state && (Symbol)j == halt_symbol) {
+                memcpy(out, "1RZ", 3);
+                out += 3;
+            } else {
+                memcpy(out, "---", 3);
+                out += 3;
+            }
+        }
+    }
+    *out = '\0';
+
+    return text;
+}
+
+// Counts the machine that reached the undefined transition of the state and symbol.
+static void record_halt(struct Search* const search, const size_t state, const Symbol symbol) {
+    struct Tally* const tally = &search->tally;
+    const struct Configuration* const configuration = &search->configuration;
+
+    ++tally->halted;
+
+    // The transition that halts is a step as well.
+    const size_t steps = configuration->steps + 1;
+    if(steps < tally->best) {
+        return;
+    }
+
+    if(steps > tally->best) {
+        for(size_t i = 0; i < tally->champions_size; ++i) {
+            free(tally->champions[i].machine);
+        }
+        tally->champions_size = 0;
+        tally->best = steps;
+    }
+
+    if(tally->champions_size >= tally->champions_allocated) {
+        tally->champions_allocated = tally->champions_allocated == 0 ? 8 : tally->champions_allocated * 2;
+        tally->champions = realloc(tally->champions, sizeof(struct Champion) * tally->champions_allocated);
+
+        if(tally->champions == NULL) {
+            out_of_memory();
+        }
+    }
+
+    // The transition that halts writes a 1 over the symbol.
+    size_t cells = symbol == 0 ? 1 : 0;
+    for(long i = configuration->low; i <= configuration->high; ++i) {
+        cells += search->cells[search->origin + i] != 0;
+    }
+
+    tally->champions[tally->champions_size++] = (struct Champion){
+        .machine = notation(search, state, symbol),
+        .cells = cells
+    };
+}
+
+/* Tries to prove that the machine never reaches an undefined transition
+ * with the static deciders and the cycle detection, which runs the machine
+ * from the start for at most `limit` steps.
+ *
+ * @return true if it never halts. Otherwise `reached` is set if the cycle
+ *         detection ran into an undefined transition within the limit.
+ */
+static bool never_halts(struct Search* const search, const size_t limit, bool* const reached) {
+    *reached = false;
+
+    if(decide(&search->machine) != VERDICT_UNKNOWN) {
+        return true;
+    }
+
+    // A small tape on the heap that only grows as far as the machine goes, as the
+    // cycle detection looks at all of its cells first and most machines loop early.
+    struct Tape tape = {
+        .content = allocate(sizeof(Symbol) * 16),
+        .size = 16,
+        .cursor = 8,
+        .symbol_len = search->enumeration->symbols
+    };
+
+    StateId state = search->table.start;
+    struct Cycle cycle;
+    run_table_cycles(&search->table, &tape, &state, limit, &cycle);
+
+    free_tape(&tape);
+
+    *reached = state == search->table.halt;
+
+    return cycle.period > 0;
+}
+
+static void record_undecided(struct Search* const search) {
+    ++search->tally.undecided;
+
+    if(!search->enumeration->keep_undecided) {
+        return;
+    }
+
+    if(search->undecided_size >= search->undecided_allocated) {
+        search->undecided_allocated = search->undecided_allocated == 0 ? 64 : search->undecided_allocated * 2;
+        search->undecided = realloc(search->undecided, sizeof(char*) * search->undecided_allocated);
+
+        if(search->undecided == NULL) {
+            out_of_memory();
+        }
+    }
+
+    search->undecided[search->undecided_size++] = notation(search, search->enumeration->states, 0);
+}
+
+static size_t child_count(const struct Enumeration* const enumeration, const struct Node node) {
+    const size_t states = node.states < enumeration->states ? node.states + 1 : node.states;
+    const size_t symbols = node.symbols < enumeration->symbols ? node.symbols + 1 : node.symbols;
+
+    // A machine whose first transition moves to the left is the mirror image of one that moves to the right.
+    return states * symbols * (node.defined == 0 ? 1 : 2);
+}
+
+/* The `index`th way to define the next transition of the node. The next state and the written
+ * symbol can only be one that is used already or the first one that is not.
+ */
+static struct Child child_at(const struct Enumeration* const enumeration, const struct Node node, size_t index) {
+    const size_t symbols = node.symbols < enumeration->symbols ? node.symbols + 1 : node.symbols;
+    struct Child child = {.direction = RIGHT};
+
+    if(node.defined > 0) {
+        child.direction = index % 2 == 0 ? RIGHT : LEFT;
+        index /= 2;
+    }
+
+    child.write = (Symbol)(index % symbols);
+    child.next = (StateId)(index / symbols);
+
+    return child;
+}
+
+static struct Node child_node(const struct Node node, const struct Child child) {
+    return (struct Node){
+        .defined = node.defined + 1,
+        .states = child.next == node.states ? node.states + 1 : node.states,
+        .symbols = (size_t)child.write == node.symbols ? node.symbols + 1 : node.symbols
+    };
+}
+
+static void push_pending(struct Search* const search, const struct Node node) {
+    const size_t rules_size = search->enumeration->states * search->enumeration->symbols;
+
+    if(search->pending_size >= search->pending_allocated) {
+        search->pending_allocated = search->pending_allocated == 0 ? 64 : search->pending_allocated * 2;
+        search->pending = realloc(search->pending, sizeof(PackedRule) * rules_size * search->pending_allocated);
+        search->pending_nodes = realloc(search->pending_nodes, sizeof(struct Node) * search->pending_allocated);
+
+        if(search->pending == NULL || search->pending_nodes == NULL) {
+            out_of_memory();
+        }
+    }
+
+    memcpy(search->pending + search->pending_size * rules_size, search->table.rules, sizeof(PackedRule) * rules_size);
+    search->pending_nodes[search->pending_size++] = node;
+}
+
+/* Counts the machine that reached an undefined transition.
+ *
+ * @return true if the transition can be defined.
+ */
+static bool halted_node(struct Search* const search, const struct Node node) {
+    const struct Configuration* const configuration = &search->configuration;
+    record_halt(search, configuration->state, search->cells[search->origin + configuration->head]);
+
+    // Without any undefined transition, the machine could not halt anymore.
+    return node.defined + 1 < search->enumeration->states * search->enumeration->symbols;
+}
+
+/* Runs the machine of the node. If it is still running after the probe and
+ * `defer` is set, it is left for the lockstep engine if possible.
+ *
+ * @return true if the machine reached an undefined transition that can be defined.
+ */
+static bool run_node(struct Search* const search, const struct Node node, const bool defer) {
+    const size_t max_iter = search->enumeration->max_iter;
+    const size_t probe = search->configuration.steps + PROBE_STEPS;
+    bool reached;
+
+    if(run_search(search, probe < max_iter ? probe : max_iter)) {
+        return halted_node(search, node);
+    }
+
+    // The steps that are left are not simulated by the cycle detection if the engine runs them.
+    const bool pending = search->configuration.steps < max_iter && defer && search->lockstep;
+    const size_t cycle_steps = search->configuration.steps > CYCLE_STEPS ? search->configuration.steps : CYCLE_STEPS;
+    const size_t limit = pending && cycle_steps < max_iter ? cycle_steps : max_iter;
+
+    if(never_halts(search, limit, &reached)) {
+        ++search->tally.looped;
+        return false;
+    }
+
+    if(pending) {
+        push_pending(search, node);
+        return false;
+    }
+
+    // The cycle detection already ran the whole budget, so only a machine that reached
+    // an undefined transition is run again to find the configuration for its children.
+    if(!reached) {
+        record_undecided(search);
+        return false;
+    }
+
+    run_search(search, max_iter);
+
+    return halted_node(search, node);
+}
+
+static void explore(struct Search* const search, const struct Node node);
+
+// Runs the children of the node, which reached an undefined transition.
+static void explore_children(struct Search* const search, const struct Node node) {
+    const size_t state = search->configuration.state;
+    const Symbol symbol = search->cells[search->origin + search->configuration.head];
+    const size_t children = child_count(search->enumeration, node);
+
+    save_snapshot(search, node.defined);
+
+    for(size_t i = 0; i < children; ++i) {
+        // Every child continues where the machine reached the transition.
+        if(i > 0) {
+            restore_snapshot(search, node.defined);
+        }
+
+        const struct Child child = child_at(search->enumeration, node, i);
+        define(search, state, symbol, pack_rule(&search->table, child.write, child.direction, child.next));
+        explore(search, child_node(node, child));
+    }
+
+    define(search, state, symbol, pack_rule(&search->table, 0, LEFT, search->table.halt));
+}
+
+static void explore(struct Search* const search, const struct Node node) {
+    if(run_node(search, node, true)) {
+        explore_children(search, node);
+    }
+}
+
+/* Runs the machines that were left for the lockstep engine. The few that halt
+ * are run again on their own to find the configuration for their children,
+ * which can leave more machines for the engine.
+ */
+static void run_pending(struct Search* const search) {
+    const size_t rules_size = search->enumeration->states * search->enumeration->symbols;
+    const size_t max_iter = search->enumeration->max_iter;
+
+    while(search->pending_size > 0) {
+        PackedRule* const pending = search->pending;
+        struct Node* const nodes = search->pending_nodes;
+        const size_t size = search->pending_size;
+
+        search->pending = NULL;
+        search->pending_nodes = NULL;
+        search->pending_size = 0;
+        search->pending_allocated = 0;
+
+        struct TransitionTable* const tables = allocate(sizeof(struct TransitionTable) * size);
+        struct LockstepResult* const results = allocate(sizeof(struct LockstepResult) * size);
+
+        for(size_t i = 0; i < size; ++i) {
+            tables[i] = search->table;
+            tables[i].rules = pending + i * rules_size;
+        }
+
+        run_lockstep(tables, size, max_iter, results);
+
+        for(size_t i = 0; i < size; ++i) {
+            load_prefix(search, &(struct Prefix){.rules = pending + i * rules_size, .node = nodes[i]});
+
+            // Only the machines that halted or left the cells of the engine are run again.
+            if(results[i].status == LOCKSTEP_BUDGET || !run_search(search, max_iter)) {
+                record_undecided(search);
+            } else if(halted_node(search, nodes[i])) {
+                explore_children(search, nodes[i]);
+            }
+        }
+
+        free(tables);
+        free(results);
+        free(pending);
+        free(nodes);
+    }
+}
+
+/* Runs the top of the tree level by level until there are enough
+ * prefixes for the pool or the whole tree was searched.
+ */
+static void expand_frontier(struct Enumeration* const enumeration, struct Search* const search, struct Arena* const arena) {
+    const size_t rules_size = enumeration->states * enumeration->symbols;
+    const struct TransitionTable* const table = &search->table;
+
+    struct Prefix* level = allocate(sizeof(struct Prefix));
+    size_t level_size = 1;
+
+    level[0] = (struct Prefix){
+        .rules = arena_alloc(arena, sizeof(PackedRule) * rules_size),
+        .node = {.states = 1, .symbols = 1}
+    };
+    for(size_t i = 0; i < rules_size; ++i) {
+        level[0].rules[i] = pack_rule(table, 0, LEFT, table->halt);
+    }
+
+    while(level_size > 0 && level_size < FRONTIER_SIZE) {
+        struct Prefix* next = NULL;
+        size_t next_size = 0;
+        size_t allocated = 0;
+
+        for(size_t i = 0; i < level_size; ++i) {
+            load_prefix(search, &level[i]);
+
+            if(!run_node(search, level[i].node, false)) {
+                continue;
+            }
+
+            const size_t index = search->configuration.state * enumeration->symbols + search->cells[search->origin + search->configuration.head];
+            const size_t children = child_count(enumeration, level[i].node);
+
+            for(size_t j = 0; j < children; ++j) {
+                if(next_size >= allocated) {
+                    allocated = allocated == 0 ? 64 : allocated * 2;
+                    next = realloc(next, sizeof(struct Prefix) * allocated);
+
+                    if(next == NULL) {
+                        out_of_memory();
+                    }
+                }
+
+                const struct Child child = child_at(enumeration, level[i].node, j);
+                PackedRule* const rules = arena_alloc(arena, sizeof(PackedRule) * rules_size);
+                memcpy(rules, level[i].rules, sizeof(PackedRule) * rules_size);
+                rules[index] = pack_rule(table, child.write, child.direction, child.next);
+
+                next[next_size++] = (struct Prefix){
+                    .rules = rules,
+                    .node = child_node(level[i].node, child)
+                };
+            }
+        }
+
+        free(level);
+        level = next;
+        level_size = next_size;
+    }
+
+    enumeration->prefixes = level;
+    enumeration->size = level_size;
+}
+
+static void run_prefix(void* const context, const size_t index, const size_t worker) {
+    struct Enumeration* const enumeration = context;
+    struct Search* const search = &enumeration->searches[worker];
+
+    if(!search->ready) {
+        init_search(search, enumeration);
+    }
+
+    load_prefix(search, &enumeration->prefixes[index]);
+    explore(search, enumeration->prefixes[index].node);
+
+    // Too few machines would leave most of the lanes of the engine idle.
+    if(search->pending_size >= LOCKSTEP_BATCH) {
+        run_pending(search);
+    }
+}
+
+// Runs the machines that are left for the lockstep engine by the `index`th search.
+static void finish_search(void* const context, const size_t index, const size_t worker) {
+    (void)worker;
+    struct Enumeration* const enumeration = context;
+
+    if(enumeration->searches[index].ready) {
+        run_pending(&enumeration->searches[index]);
+    }
+}
+
+static int compare_machines(const void* const first, const void* const second) {
+    return strcmp(*(char* const*)first, *(char* const*)second);
+}
+
+static int compare_champions(const void* const first, const void* const second) {
+    return strcmp(((const struct Champion*)first)->machine, ((const struct Champion*)second)->machine);
+}
+
+/* Reads `<states>,<symbols>`.
+ *
+ * @return true if both are numbers in range.
+ */
+static bool parse_size(const char* const size, size_t* const states, size_t* const symbols) {
+    char* end;
+    const unsigned long first = strtoul(size, &end, 10);
+    if(end == size || *end != ',') {
+        return false;
+    }
+
+    const char* const second_start = end + 1;
+    const unsigned long second = strtoul(second_start, &end, 10);
+    if(end == second_start || *end != '\0') {
+        return false;
+    }
+
+    *states = first;
+    *symbols = second;
+
+    return first >= 1 && first <= MAX_STATES && second >= 2 && second <= MAX_SYMBOLS;
+}
+
+int run_enumerate(const char* const size, const struct BatchOptions* const options, const char* const undecided, FILE* const out) {
+    struct Enumeration enumeration = {
+        .max_iter = options->max_iter,
+        .keep_undecided = undecided != NULL
+    };
+
+    if(!parse_size(size, &enumeration.states, &enumeration.symbols)) {
+        fprintf(stderr, "\033[31mThe size has to be `<states>,<symbols>` with 1 to %d states and 2 to %d symbols.\033[0m\n", MAX_STATES, MAX_SYMBOLS);
+        return 1;
+    }
+
+    FILE* const undecided_file = undecided == NULL ? NULL : fopen(undecided, "w");
+    if(undecided != NULL && undecided_file == NULL) {
+        fprintf(stderr, "\033[31mCould not open `%s`.\033[0m\n", undecided);
+        return 1;
+    }
+
+    struct Arena arena = {0};
+    struct Search root;
+    init_search(&root, &enumeration);
+
+    expand_frontier(&enumeration, &root, &arena);
+
+    const size_t threads = pool_size(enumeration.size, options->threads);
+    enumeration.searches = allocate(sizeof(struct Search) * threads);
+
+    if(enumeration.size > 0) {
+        run_pool(enumeration.size, options->threads, run_prefix, &enumeration);
+        run_pool(threads, threads, finish_search, &enumeration);
+    }
+
+    // Which thread finds an undecided machine depends on the pool, so they are sorted.
+    if(undecided_file != NULL) {
+        char** machines = NULL;
+        size_t machines_size = 0;
+
+        for(size_t i = 0; i <= threads; ++i) {
+            const struct Search* const search = i == threads ? &root : &enumeration.searches[i];
+
+            if(search->ready && search->undecided_size > 0) {
+                machines = realloc(machines, sizeof(char*) * (machines_size + search->undecided_size));
+                if(machines == NULL) {
+                    out_of_memory();
+                }
+
+                memcpy(machines + machines_size, search->undecided, sizeof(char*) * search->undecided_size);
+                machines_size += search->undecided_size;
+            }
+        }
+
+        if(machines_size > 0) {
+            qsort(machines, machines_size, sizeof(char*), compare_machines);
+        }
+
+        for(size_t i = 0; i < machines_size; ++i) {
+            fprintf(undecided_file, "%s\n", machines[i]);
+            free(machines[i]);
+        }
+
+        free(machines);
+    }
+
+    struct Tally total = root.tally;
+    for(size_t i = 0; i < threads; ++i) {
+        const struct Tally* const tally = &enumeration.searches[i].tally;
+
+        total.halted += tally->halted;
+        total.looped += tally->looped;
+        total.undecided += tally->undecided;
+        total.best = tally->best > total.best ? tally->best : total.best;
+    }
+
+    fprintf(out, "halted\t%zu\nlooped\t%zu\nundecided\t%zu\n", total.halted, total.looped, total.undecided);
+
+    // The champions of all searches that found the most steps, sorted to not depend on the threads.
+    struct Champion* champions = NULL;
+    size_t champions_size = 0;
+
+    for(size_t i = 0; i <= threads; ++i) {
+        const struct Search* const search = i == threads ? &root : &enumeration.searches[i];
+
+        if(search->ready && search->tally.best == total.best) {
+            champions = realloc(champions, sizeof(struct Champion) * (champions_size + search->tally.champions_size + 1));
+            if(champions == NULL) {
+                out_of_memory();
+            }
+
+            memcpy(champions + champions_size, search->tally.champions, sizeof(struct Champion) * search->tally.champions_size);
+            champions_size += search->tally.champions_size;
+        }
+    }
+
+    if(champions_size > 0) {
+        qsort(champions, champions_size, sizeof(struct Champion), compare_champions);
+    }
+
+    for(size_t i = 0; i < champions_size; ++i) {
+        fprintf(out, "champion\t%zu\t%zu\t%s\n", total.best, champions[i].cells, champions[i].machine);
+    }
+
+    free(champions);
+
+    for(size_t i = 0; i < threads; ++i) {
+        if(enumeration.searches[i].ready) {
+            free_search(&enumeration.searches[i]);
+        }
+    }
+    free_search(&root);
+
+    free(enumeration.searches);
+    free(enumeration.prefixes);
+    free_arena(&arena);
+
+    if(undecided_file != NULL) {
+        fclose(undecided_file);
+    }
+
+    return 0;
+}
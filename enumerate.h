@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stdio.h>
+
+#include "batch.h"
+
+/* Enumerates every Turing Machine with the given amount of states and symbols
+ * (`<states>,<symbols>`, e.g. `4,2`) in tree normal form: A machine starts without
+ * any rules and is run until it reaches a transition that is not defined yet, which
+ * counts as halting. Only then the machine is split into one child for each way the
+ * transition could be defined, which continue from the same configuration.
+ *
+ * Machines that only differ in the order of their states or symbols are only
+ * generated once (new states and symbols are used in the order they appear)
+ * and the first transition always moves to the right.
+ * Machines that reach the budget of `max_iter` steps are checked with the static
+ * deciders and the cycle detection, as none of their children can halt if they loop.
+ *
+ * The subtrees are run on a pool of threads. The counts of the results and the machines
+ * that halted after the most steps are written to `out` and the undecided machines
+ * sorted into the file `undecided` (if it is not NULL), all in the compact notation
+ * `1RB1LB_1LA0LC_...` (`---` for undefined transitions and `1RZ` for the one that halts).
+ *
+ * @return The exit code of the program.
+ */
+int run_enumerate(const char* const size, const struct BatchOptions* const options, const char* const undecided, FILE* const out);
@@ -9,53 +9,38 @@ struct PositionData {
     unsigned int line;
     unsigned int line_position;
 
-    char* line_content;
+    const char* line_content;
     size_t line_amount;
 };
 
-static struct PositionData get_position(FILE *fptr) {
-    long position = ftell(fptr);
+static struct PositionData get_position(const struct Lexer* const lexer, const size_t position) {
+    const size_t line = find_line(lexer, position);
+    const size_t line_start = lexer->lines[line];
 
-    unsigned int line_position = 0;
-    char c;
-    fseek(fptr, -2, SEEK_CUR);
-
-    while(line_position < position && (c = getc(fptr)) != '\n') {
-        ++line_position;
-
-        fseek(fptr, -2, SEEK_CUR);
-    }
-
-    size_t bufsize = line_position + 10;
-    char* buf = calloc(bufsize - 1, sizeof(char));
-    
-    size_t characters = getline(&buf, &bufsize, fptr);
-
-    rewind(fptr);
-
-    unsigned int lines = 0;
-    while ((c = getc(fptr)) != EOF && ftell(fptr) != position) {
-        if(c == '\n') ++lines;
-    }
-
-    fseek(fptr, position, SEEK_SET);
+    const char* const end = memchr(lexer->source.content + line_start, '\n', lexer->source.size - line_start);
+    const size_t line_end = end == NULL ? lexer->source.size : (size_t)(end - lexer->source.content);
 
     return (struct PositionData) {
-        .line = lines,
-        .line_position = line_position,
+        .line = line,
+        .line_position = position - line_start,
 
-        .line_content = buf,
-        .line_amount = characters
+        .line_content = lexer->source.content + line_start,
+        .line_amount = line_end - line_start
     };
 }
 
 #define calc_chars(number) (int)((ceil(log10(number))+1)*sizeof(char))
 
-void print_parser_error(FILE* fptr, const char* file_name, char* error_type, const char* const error_message) {
+void print_parser_error(struct Lexer* const lexer, const size_t position_index, char* error_type, const char* const error_message) {
+    if(lexer->errors == 0 && lexer->status == 0) {
+        lexer->status = 10;
+    }
+    ++lexer->errors;
+
     fprintf(stderr, "ERROR: %s\n", error_type);
-    struct PositionData position = get_position(fptr);
+    struct PositionData position = get_position(lexer, position_index);
 
-    fprintf(stderr, "--> %s:%u:%u\n", file_name, position.line + 1, position.line_position + 1);
+    fprintf(stderr, "--> %s:%u:%u\n", lexer->file_name, position.line + 1, position.line_position + 1);
 
     int chars = calc_chars(position.line + 2);
     chars = chars > 1 ? chars : 2;
@@ -65,7 +50,7 @@ void print_parser_error(FILE* fptr, const char* file_name, char* error_type, con
     start_whitespace[chars - 1] = '\0';
 
     fprintf(stderr, "%s |\n", start_whitespace);
-    fprintf(stderr, "%u | %s", position.line + 1, position.line_content);
+    fprintf(stderr, "%u | %.*s\n", position.line + 1, (int)position.line_amount, position.line_content);
     
     char position_whitespace[position.line_position + 1];
     memset(position_whitespace, ' ', position.line_position);
@@ -1,5 +1,8 @@
 #pragma once
 
-#include <stdio.h>
+#include "lexer.h"
 
-void print_parser_error(FILE* fptr, const char* file_name, char* error_type, const char* const error_message);
+/* Prints the error with the line it occurred in and counts it in the lexer.
+ * It does not stop the program, so that all errors can be shown at once.
+ */
+void print_parser_error(struct Lexer* const lexer, const size_t position, char* error_type, const char* const error_message);
@@ -0,0 +1,60 @@
+#!/usr/bin/env bash
+# Generates machines with many states and times how long `./tau --quiet` takes
+# to parse, link and run them. As the names are resolved with hash tables,
+# the time should grow linearly with the amount of states.
+#
+#   examples/stress.sh [states...]    (default: 100000 200000 400000)
+#
+# The path of the binary can be set with TAU (default: ./tau).
+
+set -e
+
+TAU="${TAU:-./tau}"
+DIRECTORY="$(mktemp -d)"
+trap 'rm -rf "$DIRECTORY"' EXIT
+
+if [ "$#" -eq 0 ]; then
+    set -- 100000 200000 400000
+fi
+
+# Every state moves right to the next one on a blank and jumps back to a state
+# far away on a 1, so that the next states are not in the order of the file.
+# The last state halts, which it reaches after as many steps as there are states.
+generate() {
+    awk -v states="$1" 'BEGIN {
+        print "symbols = 0,1"
+        print "blank = 0"
+        print "start = S0"
+        print "end = HALT"
+        print ""
+        print "------"
+
+        for(i = 0; i < states; ++i) {
+            next_state = i + 1 < states ? "S" (i + 1) : "HALT"
+            back = "S" ((i * 7919) % states)
+
+            print ""
+            print "S" i " {"
+            print "    0 = 1, RIGHT, " next_state
+            print "    1 = 0, LEFT, " back
+            print "}"
+        }
+    }'
+}
+
+TIMEFORMAT="%R"
+
+printf "%10s %10s %14s\n" "states" "seconds" "per 100k"
+
+for states in "$@"; do
+    file="$DIRECTORY/stress_$states.tau"
+    generate "$states" > "$file"
+
+    # `date +%N` does not exist on macOS, but the time builtin of bash does.
+    # Only the output of `time` is captured, the errors of tau still go to stderr.
+    seconds="$( { time "$TAU" "$file" --quiet --max-iter "$((states + 1))" > /dev/null 2>&3; } 3>&2 2>&1 )"
+
+    awk -v states="$states" -v seconds="$seconds" 'BEGIN {
+        printf "%10d %10.3f %14.3f\n", states, seconds, seconds / states * 100000
+    }'
+done
@@ -0,0 +1,221 @@
+#include "export.h"
+
+#include <string.h>
+
+#include "memory.h"
+
+int parse_export_format(enum ExportFormat* const format, const char* const name) {
+    if(strcmp(name, "raw") == 0) {
+        *format = EXPORT_RAW;
+        return 1;
+    }
+    if(strcmp(name, "rle") == 0) {
+        *format = EXPORT_RLE;
+        return 1;
+    }
+    if(strcmp(name, "names") == 0) {
+        *format = EXPORT_NAMES;
+        return 1;
+    }
+
+    return 0;
+}
+
+int init_exporter(struct Exporter* const exporter, FILE* const out, const enum ExportFormat format, const struct Tape* const tape) {
+    // A byte can only contain the index of 256 symbols.
+    if(format == EXPORT_RAW && tape->symbol_len > 256) {
+        return 0;
+    }
+
+    exporter->out = out;
+    exporter->format = format;
+    exporter->symbol_names = tape->symbol_names;
+    exporter->def = tape->def;
+    exporter->started = false;
+    exporter->blanks = 0;
+    exporter->skipped = 0;
+    exporter->run_length = 0;
+    exporter->failed = false;
+    exporter->used = 0;
+
+    exporter->name_lengths = malloc(sizeof(size_t) * tape->symbol_len);
+    if(exporter->name_lengths == NULL) {
+        out_of_memory();
+    }
+
+    for(size_t i = 0; i < tape->symbol_len; ++i) {
+        exporter->name_lengths[i] = strlen(tape->symbol_names[i]);
+    }
+
+    return 1;
+}
+
+static void flush(struct Exporter* const exporter) {
+    if(exporter->used > 0 && fwrite(exporter->buffer, 1, exporter->used, exporter->out) != exporter->used) {
+        exporter->failed = true;
+    }
+
+    exporter->used = 0;
+}
+
+static void put(struct Exporter* const exporter, const char* const data, const size_t size) {
+    if(exporter->used + size > EXPORT_BUFFER_SIZE) {
+        flush(exporter);
+
+        // Too large for the buffer, so it is written directly.
+        if(size > EXPORT_BUFFER_SIZE) {
+            if(fwrite(data, 1, size, exporter->out) != size) {
+                exporter->failed = true;
+            }
+            return;
+        }
+    }
+
+    memcpy(exporter->buffer + exporter->used, data, size);
+    exporter->used += size;
+}
+
+static void put_name(struct Exporter* const exporter, const Symbol symbol) {
+    put(exporter, exporter->symbol_names[symbol], exporter->name_lengths[symbol]);
+}
+
+static void write_rle(struct Exporter* const exporter) {
+    char length[24];
+    const int size = snprintf(length, sizeof(length), "%zu ", exporter->run_length);
+
+    put(exporter, length, (size_t)size);
+    put_name(exporter, exporter->run_symbol);
+    put(exporter, "\n", 1);
+}
+
+// Writes a run of cells that is part of the used region.
+static void write_run(struct Exporter* const exporter, const Symbol symbol, size_t length) {
+    switch(exporter->format) {
+    case EXPORT_RAW:
+        while(length > 0) {
+            if(exporter->used == EXPORT_BUFFER_SIZE) {
+                flush(exporter);
+            }
+
+            const size_t available = EXPORT_BUFFER_SIZE - exporter->used;
+            const size_t amount = length < available ? length : available;
+
+            memset(exporter->buffer + exporter->used, (unsigned char)symbol, amount);
+            exporter->used += amount;
+            length -= amount;
+        }
+        break;
+    case EXPORT_RLE:
+        if(exporter->run_length > 0 && exporter->run_symbol != symbol) {
+            write_rle(exporter);
+            exporter->run_length = 0;
+        }
+
+        exporter->run_symbol = symbol;
+        exporter->run_length += length;
+        break;
+    case EXPORT_NAMES:
+        for(size_t i = 0; i < length; ++i) {
+            // Every name except the first one is preceded by a comma.
+            if(exporter->started || i > 0) {
+                put(exporter, ",", 1);
+            }
+            put_name(exporter, symbol);
+        }
+        break;
+    }
+}
+
+void export_run(struct Exporter* const exporter, const Symbol symbol, const size_t length) {
+    if(length == 0) {
+        return;
+    }
+
+    if(symbol == exporter->def) {
+        exporter->blanks += length;
+        return;
+    }
+
+    // The blanks in front of the first cell that is not blank are not part of the used region.
+    if(exporter->started && exporter->blanks > 0) {
+        write_run(exporter, exporter->def, exporter->blanks);
+    } else if(!exporter->started) {
+        exporter->skipped = exporter->blanks;
+    }
+    exporter->blanks = 0;
+
+    write_run(exporter, symbol, length);
+    exporter->started = true;
+}
+
+void export_cells(struct Exporter* const exporter, const Symbol* const cells, const size_t size) {
+    size_t i = 0;
+
+    while(i < size) {
+        size_t end = i + 1;
+        while(end < size && cells[end] == cells[i]) {
+            ++end;
+        }
+
+        export_run(exporter, cells[i], end - i);
+        i = end;
+    }
+}
+
+void export_bytes(struct Exporter* const exporter, const uint8_t* const cells, const size_t size) {
+    size_t i = 0;
+
+    while(i < size) {
+        size_t end = i + 1;
+        while(end < size && cells[end] == cells[i]) {
+            ++end;
+        }
+
+        export_run(exporter, cells[i], end - i);
+        i = end;
+    }
+}
+
+void export_bits(struct Exporter* const exporter, const uint64_t* const words, const size_t from, const size_t size) {
+    const size_t end = from + size;
+    size_t i = from;
+
+    while(i < end) {
+        const bool bit = (words[i >> 6] >> (i & 63)) & 1;
+        const uint64_t flip = bit ? ~(uint64_t)0 : 0;
+
+        // Finds the next bit that is different with whole words at once.
+        size_t next = i;
+        while(next < end) {
+            const uint64_t different = (words[next >> 6] ^ flip) >> (next & 63);
+
+            if(different != 0) {
+                next += __builtin_ctzll(different);
+                break;
+            }
+
+            next += 64 - (next & 63);
+        }
+
+        next = next < end ? next : end;
+        export_run(exporter, bit, next - i);
+        i = next;
+    }
+}
+
+int finish_export(struct Exporter* const exporter) {
+    if(exporter->format == EXPORT_RLE && exporter->run_length > 0) {
+        write_rle(exporter);
+    }
+
+    if(exporter->format == EXPORT_NAMES && exporter->started) {
+        put(exporter, "\n", 1);
+    }
+
+    flush(exporter);
+
+    free(exporter->name_lengths);
+    exporter->name_lengths = NULL;
+
+    return !exporter->failed && fflush(exporter->out) == 0;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "tape.h"
+
+enum ExportFormat {
+    // Every cell is a byte with the index of its symbol.
+    EXPORT_RAW,
+    // Every run of the same symbol is a line: `<length> <name>`
+    EXPORT_RLE,
+    // The names of the symbols separated by commas (like the tape in the head).
+    EXPORT_NAMES
+};
+
+#define EXPORT_BUFFER_SIZE ((size_t)1 << 16)
+
+/* Writes the cells of a tape from left to right into a file.
+ * Only the part between the leftmost and the rightmost cell
+ * that is not blank is written, which is why blanks are only
+ * written once a cell that is not blank follows them.
+ *
+ * The tapes of all engines are written as runs, so that long runs
+ * of the same symbol do not have to be converted cell by cell.
+ */
+struct Exporter {
+    FILE* out;
+    enum ExportFormat format;
+
+    char** symbol_names;
+    size_t* name_lengths;
+    Symbol def;
+
+    // Whether a cell that is not blank was written
+    bool started;
+    // The blanks since the last cell that is not blank
+    size_t blanks;
+    // The blanks in front of the first cell that is not blank, which were not written
+    size_t skipped;
+
+    // The run that is not written yet (only used for EXPORT_RLE)
+    Symbol run_symbol;
+    size_t run_length;
+
+    bool failed;
+
+    size_t used;
+    char buffer[EXPORT_BUFFER_SIZE];
+};
+
+/* Parses the name of a format.
+ *
+ * @return 1 if it is a known format and 0 otherwise.
+ */
+int parse_export_format(enum ExportFormat* const format, const char* const name);
+
+/* Prepares the exporter for a tape with the symbols of `tape`.
+ *
+ * @return 1 if it was successful and 0 if the symbols cannot be written in this format.
+ */
+int init_exporter(struct Exporter* const exporter, FILE* const out, const enum ExportFormat format, const struct Tape* const tape);
+
+void export_run(struct Exporter* const exporter, const Symbol symbol, const size_t length);
+
+void export_cells(struct Exporter* const exporter, const Symbol* const cells, const size_t size);
+
+void export_bytes(struct Exporter* const exporter, const uint8_t* const cells, const size_t size);
+
+// Exports `size` bits starting with the bit `from`.
+void export_bits(struct Exporter* const exporter, const uint64_t* const words, const size_t from, const size_t size);
+
+/* Writes everything that is left and frees the exporter (but does not close the file).
+ *
+ * @return 1 if everything was written and 0 otherwise.
+ */
+int finish_export(struct Exporter* const exporter);
@@ -0,0 +1,259 @@
+#include "inputs.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "cycle.h"
+#include "memory.h"
+#include "pool.h"
+#include "tapefile.h"
+
+struct InputResult {
+    bool done;
+    struct BatchResult result;
+
+    // The final tape (with a trailing newline if it is not empty)
+    char* tape;
+    size_t tape_length;
+};
+
+// Every thread reuses its tape, so that no address space has to be reserved per input.
+struct InputWorker {
+    bool ready;
+    struct Tape tape;
+    // The cells that the last input could have changed
+    size_t from;
+    size_t to;
+
+    struct Exporter exporter;
+};
+
+struct Inputs {
+    const struct TuringMachine* machine;
+    // NULL if the machine is too large for a table
+    const struct TransitionTable* table;
+    const struct BatchOptions* options;
+    struct SymbolLookup lookup;
+
+    struct MappedFile file;
+    // Where the lines start (and one more for the end of the last line)
+    size_t* lines;
+    size_t size;
+
+    // The lines that are run by the pool at the moment
+    size_t start;
+    size_t window;
+
+    struct InputResult* results;
+    struct InputWorker* workers;
+
+    // Protects the results and the output.
+    pthread_mutex_t lock;
+    size_t next;
+    FILE* out;
+};
+
+static void find_lines(struct Inputs* const inputs) {
+    size_t allocated = 64;
+    inputs->lines = malloc(sizeof(size_t) * allocated);
+    inputs->size = 0;
+
+    if(inputs->lines == NULL) {
+        out_of_memory();
+    }
+
+    size_t start = 0;
+    while(true) {
+        inputs->lines[inputs->size] = start;
+        if(start >= inputs->file.size) {
+            break;
+        }
+        ++inputs->size;
+
+        const char* const newline = memchr(inputs->file.content + start, '\n', inputs->file.size - start);
+        start = newline == NULL ? inputs->file.size : (size_t)(newline - inputs->file.content) + 1;
+
+        if(inputs->size + 1 >= allocated) {
+            allocated *= 2;
+            inputs->lines = realloc(inputs->lines, sizeof(size_t) * allocated);
+
+            if(inputs->lines == NULL) {
+                out_of_memory();
+            }
+        }
+    }
+}
+
+// Runs the machine without a table on its own copy of the state.
+static struct BatchResult run_states(const struct TuringMachine* const machine, struct Tape* const tape, const size_t max_iter) {
+    struct TuringMachine copy = *machine;
+    copy.tape = *tape;
+
+    struct BatchResult result = {0};
+    while(copy.state != NULL && result.steps < max_iter) {
+        next_state(&copy);
+        ++result.steps;
+    }
+
+    *tape = copy.tape;
+    result.status = copy.state == NULL ? BATCH_HALTED : BATCH_BUDGET;
+
+    return result;
+}
+
+static struct BatchResult run_on_table(const struct TransitionTable* const table, struct Tape* const tape, const struct BatchOptions* const options) {
+    struct BatchResult result = {0};
+    StateId state = table->start;
+    struct Cycle cycle = {0};
+
+    if(options->cycles) {
+        result.steps = run_table_cycles(table, tape, &state, options->max_iter, &cycle);
+    } else {
+        result.steps = run_table(table, tape, &state, options->max_iter);
+    }
+
+    if(state == table->halt) {
+        result.status = BATCH_HALTED;
+    } else {
+        result.status = cycle.period > 0 ? BATCH_LOOPED : BATCH_BUDGET;
+    }
+
+    return result;
+}
+
+// Writes all results that are done and have no unfinished results in front of them.
+static void write_done(struct Inputs* const inputs) {
+    while(inputs->next < inputs->window && inputs->results[inputs->next].done) {
+        struct InputResult* const input = &inputs->results[inputs->next];
+
+        fprintf(inputs->out, "%zu\t%s\t%zu\t", inputs->start + inputs->next + 1, batch_status_name(input->result.status), input->result.steps);
+        if(input->tape_length > 0) {
+            fwrite(input->tape, 1, input->tape_length, inputs->out);
+        } else {
+            fputc('\n', inputs->out);
+        }
+
+        free(input->tape);
+        input->tape = NULL;
+
+        ++inputs->next;
+    }
+}
+
+static void run_input(void* const context, const size_t window_index, const size_t worker_index) {
+    struct Inputs* const inputs = context;
+    const size_t index = inputs->start + window_index;
+    struct InputWorker* const worker = &inputs->workers[worker_index];
+    const struct Tape* const initial = &inputs->machine->tape;
+
+    const char* const text = inputs->file.content + inputs->lines[index];
+    const size_t length = inputs->lines[index + 1] - inputs->lines[index];
+
+    struct InputResult input = {.done = true};
+
+    // Every name is followed by a separator, so this is the most cells there can be.
+    struct Tape* const tape = &worker->tape;
+    if(!worker->ready) {
+        *tape = init_tape_blank(initial->def, 1);
+        tape->symbol_names = initial->symbol_names;
+        tape->symbol_len = initial->symbol_len;
+        worker->ready = true;
+    }
+    reset_tape(tape, worker->from, worker->to, length / 2 + 1);
+
+    size_t cells;
+    size_t error;
+    if(decode_names(&inputs->lookup, text, length, tape->content + tape->cursor, &cells, &error)) {
+        if(inputs->table != NULL) {
+            input.result = run_on_table(inputs->table, tape, inputs->options);
+        } else {
+            input.result = run_states(inputs->machine, tape, inputs->options->max_iter);
+        }
+
+        // Every step can only move one cell away from the input.
+        const size_t reach = input.result.steps + cells + 1;
+        worker->from = tape->cursor > reach ? tape->cursor - reach : 0;
+        worker->to = tape->size - tape->cursor > reach ? tape->cursor + reach : tape->size;
+
+        FILE* const memory = open_memstream(&input.tape, &input.tape_length);
+        if(memory == NULL) {
+            out_of_memory();
+        }
+
+        init_exporter(&worker->exporter, memory, EXPORT_NAMES, tape);
+        export_cells(&worker->exporter, tape->content + worker->from, worker->to - worker->from);
+        finish_export(&worker->exporter);
+        fclose(memory);
+    } else {
+        fprintf(stderr, "\033[31mCell %zu of line %zu is not a symbol.\033[0m\n", cells, index + 1);
+        input.result.status = BATCH_ERROR;
+
+        worker->from = tape->cursor;
+        worker->to = tape->cursor + cells;
+    }
+
+    pthread_mutex_lock(&inputs->lock);
+    inputs->results[window_index] = input;
+    write_done(inputs);
+    pthread_mutex_unlock(&inputs->lock);
+}
+
+int run_inputs(const struct TuringMachine* const machine, const char* const file_name, const struct BatchOptions* const options, FILE* const out) {
+    struct Inputs inputs = {
+        .machine = machine,
+        .options = options,
+        .out = out
+    };
+
+    if(!map_file(&inputs.file, file_name)) {
+        fprintf(stderr, "File path `%s` does not exist.\n", file_name);
+        return 1;
+    }
+
+    find_lines(&inputs);
+
+    struct TransitionTable table;
+    if(compile_table(&table, machine)) {
+        inputs.table = &table;
+    }
+
+    inputs.lookup = init_symbol_lookup(&machine->tape);
+    const size_t window = inputs.size < POOL_WINDOW ? inputs.size : POOL_WINDOW;
+    const size_t workers = pool_size(window, options->threads);
+    inputs.results = calloc(window > 0 ? window : 1, sizeof(struct InputResult));
+    inputs.workers = calloc(workers, sizeof(struct InputWorker));
+    if(inputs.results == NULL || inputs.workers == NULL) {
+        out_of_memory();
+    }
+    pthread_mutex_init(&inputs.lock, NULL);
+
+    // Only the final tapes of one window are kept in memory.
+    for(inputs.start = 0; inputs.start < inputs.size; inputs.start += inputs.window) {
+        inputs.window = inputs.size - inputs.start < window ? inputs.size - inputs.start : window;
+        inputs.next = 0;
+        memset(inputs.results, 0, sizeof(struct InputResult) * inputs.window);
+
+        run_pool(inputs.window, options->threads, run_input, &inputs);
+        fflush(out);
+    }
+
+    for(size_t i = 0; i < workers; ++i) {
+        if(inputs.workers[i].ready) {
+            free_tape(&inputs.workers[i].tape);
+        }
+    }
+
+    pthread_mutex_destroy(&inputs.lock);
+    free(inputs.results);
+    free(inputs.workers);
+    free_symbol_lookup(&inputs.lookup);
+    free(inputs.lines);
+    unmap_file(&inputs.file);
+
+    if(inputs.table != NULL) {
+        free_table(&table);
+    }
+
+    return 0;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stdio.h>
+
+#include "batch.h"
+#include "turingmachine.h"
+
+/* Runs the machine once for every line of the file `inputs`, which contains
+ * the initial tape as names of symbols (like `--tape`) with the head on the
+ * first cell. The transition table is only compiled once and shared by all
+ * threads, while every run has its own tape.
+ *
+ * One line is written per input in the same order, as soon as it and all
+ * of the inputs before it are done:
+ *
+ *   <line>\t<result>\t<steps>\t<final tape>
+ *
+ * The final tape is written like `--export` with the format `names`.
+ *
+ * @return The exit code of the program.
+ */
+int run_inputs(const struct TuringMachine* const machine, const char* const inputs, const struct BatchOptions* const options, FILE* const out);
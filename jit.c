@@ -0,0 +1,398 @@
+#include "jit.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__x86_64__) && (defined(__unix__) || defined(__APPLE__))
+#include <sys/mman.h>
+
+#define JIT_SUPPORTED
+#endif
+
+/* The state that is shared between the native code and C.
+ * The offsets of the members are used by the generated code.
+ */
+struct JitContext {
+    Symbol* content;  // 0
+    size_t size;      // 8
+    size_t cursor;    // 16
+    size_t remaining; // 24
+    StateId state;    // 32
+
+    struct Tape* tape;
+};
+
+typedef void (*JitFunction)(struct JitContext* const context);
+
+#ifdef JIT_SUPPORTED
+
+_Static_assert(offsetof(struct JitContext, state) == 32, "The generated code depends on the layout of the context.");
+
+// Only called by the native code if the head leaves the tape.
+static void jit_left(struct JitContext* const context) {
+    struct Tape* const tape = context->tape;
+
+    tape->cursor = context->cursor;
+    left(tape);
+
+    context->content = tape->content;
+    context->size = tape->size;
+    context->cursor = tape->cursor;
+}
+
+// The cursor has already been moved onto the first cell after the tape.
+static void jit_right(struct JitContext* const context) {
+    struct Tape* const tape = context->tape;
+
+    tape->cursor = context->cursor - 1;
+    right(tape);
+
+    context->content = tape->content;
+    context->size = tape->size;
+    context->cursor = tape->cursor;
+}
+
+/* Registers that are used by the generated code:
+ *
+ *   rbx  The context
+ *   r12  The content of the tape
+ *   r13  The cursor
+ *   r14  The size of the tape
+ *   r15  The remaining steps
+ *   eax  The current symbol
+ */
+
+// Symbol counts up to this are dispatched with comparisons instead of a jump table.
+#define MAX_COMPARISONS 4
+
+struct Fixup {
+    size_t position;
+    StateId state;
+};
+
+struct Emitter {
+    unsigned char* code;
+    size_t size;
+
+    struct Fixup* fixups;
+    size_t fixups_size;
+};
+
+static void emit(struct Emitter* const emitter, const unsigned char* const bytes, const size_t amount) {
+    memcpy(emitter->code + emitter->size, bytes, amount);
+    emitter->size += amount;
+}
+
+#define EMIT(emitter, ...) do { \
+        const unsigned char bytes[] = {__VA_ARGS__}; \
+        emit(emitter, bytes, sizeof(bytes)); \
+    } while(0)
+
+static void emit_32(struct Emitter* const emitter, const uint32_t value) {
+    emit(emitter, (const unsigned char*)&value, sizeof(value));
+}
+
+static void emit_64(struct Emitter* const emitter, const uint64_t value) {
+    emit(emitter, (const unsigned char*)&value, sizeof(value));
+}
+
+static void patch_32(struct Emitter* const emitter, const size_t position, const uint32_t value) {
+    memcpy(emitter->code + position, &value, sizeof(value));
+}
+
+// Emits the rel32 of a jump to a state which is resolved after all states are emitted.
+static void emit_state_target(struct Emitter* const emitter, const StateId state) {
+    emitter->fixups[emitter->fixups_size++] = (struct Fixup){
+        .position = emitter->size,
+        .state = state
+    };
+
+    emit_32(emitter, 0);
+}
+
+static void emit_jump_state(struct Emitter* const emitter, const StateId state) {
+    EMIT(emitter, 0xE9); // jmp rel32
+    emit_state_target(emitter, state);
+}
+
+static void emit_reload(struct Emitter* const emitter) {
+    EMIT(emitter,
+        0x4C, 0x8B, 0x63, 0x00, // mov r12, [rbx + 0]
+        0x4C, 0x8B, 0x73, 0x08, // mov r14, [rbx + 8]
+        0x4C, 0x8B, 0x6B, 0x10  // mov r13, [rbx + 16]
+    );
+}
+
+static void emit_call(struct Emitter* const emitter, void (*function)(struct JitContext* const)) {
+    EMIT(emitter,
+        0x4C, 0x89, 0x6B, 0x10, // mov [rbx + 16], r13
+        0x48, 0x89, 0xDF,       // mov rdi, rbx
+        0x48, 0xB8              // mov rax, imm64
+    );
+    emit_64(emitter, (uint64_t)(uintptr_t)function);
+    EMIT(emitter, 0xFF, 0xD0);  // call rax
+
+    emit_reload(emitter);
+}
+
+// The length of the code that is emitted by `emit_call`.
+#define CALL_LENGTH 31
+
+static void emit_rule(struct Emitter* const emitter, const struct TransitionTable* const table, const PackedRule rule, const Symbol read) {
+    const Symbol symbol = RULE_SYMBOL(table, rule);
+    const StateId next = RULE_NEXT(table, rule);
+
+    // Writing the same symbol again can be skipped.
+    if(symbol != read) {
+        EMIT(emitter, 0x66, 0x43, 0xC7, 0x04, 0x6C); // mov word [r12 + r13 * 2], imm16
+        EMIT(emitter, (unsigned char)(symbol & 0xFF), (unsigned char)((symbol >> 8) & 0xFF));
+    }
+
+    switch(RULE_DIRECTION(table, rule)) {
+    case RIGHT:
+        EMIT(emitter,
+            0x49, 0xFF, 0xC5,      // inc r13
+            0x4D, 0x39, 0xF5,      // cmp r13, r14
+            0x72, CALL_LENGTH      // jb over the call
+        );
+        emit_call(emitter, jit_right);
+        break;
+    case LEFT:
+        EMIT(emitter,
+            0x4D, 0x85, 0xED,      // test r13, r13
+            0x74, 3 + 5,           // jz over the dec and jmp
+            0x49, 0xFF, 0xCD       // dec r13
+        );
+        emit_jump_state(emitter, next);
+        emit_call(emitter, jit_left);
+        break;
+    case STAY:
+        // Do nothing
+        break;
+    }
+
+    emit_jump_state(emitter, next);
+}
+
+// Emits `mov eax, state` and jumps to the exit which is at the start of the code.
+static void emit_exit(struct Emitter* const emitter, const StateId state, const size_t exit) {
+    EMIT(emitter, 0xB8);                                  // mov eax, imm32
+    emit_32(emitter, state);
+    EMIT(emitter, 0xE9);                                  // jmp rel32
+    emit_32(emitter, (uint32_t)(exit - (emitter->size + 4)));
+}
+
+static void emit_state(struct Emitter* const emitter, const struct TransitionTable* const table, const StateId state, const size_t exit, size_t* const tables, size_t* const tables_size) {
+    EMIT(emitter,
+        0x4D, 0x85, 0xFF,         // test r15, r15
+        0x75, 5 + 5               // jnz over the exit
+    );
+    emit_exit(emitter, state, exit);
+
+    EMIT(emitter,
+        0x49, 0xFF, 0xCF,         // dec r15
+        0x43, 0x0F, 0xB7, 0x04, 0x6C // movzx eax, word [r12 + r13 * 2]
+    );
+
+    const PackedRule* const rules = &table->rules[state * table->symbol_len];
+
+    if(table->symbol_len <= MAX_COMPARISONS) {
+        size_t jumps[MAX_COMPARISONS];
+
+        for(size_t i = 0; i + 1 < table->symbol_len; ++i) {
+            EMIT(emitter, 0x3D);                  // cmp eax, imm32
+            emit_32(emitter, i);
+            EMIT(emitter, 0x0F, 0x84);            // je rel32
+            jumps[i] = emitter->size;
+            emit_32(emitter, 0);
+        }
+
+        // The last symbol does not have to be compared.
+        emit_rule(emitter, table, rules[table->symbol_len - 1], table->symbol_len - 1);
+
+        for(size_t i = 0; i + 1 < table->symbol_len; ++i) {
+            patch_32(emitter, jumps[i], (uint32_t)(emitter->size - (jumps[i] + 4)));
+            emit_rule(emitter, table, rules[i], i);
+        }
+
+        return;
+    }
+
+    EMIT(emitter, 0x48, 0x8D, 0x0D);             // lea rcx, [rip + rel32]
+    tables[(*tables_size)++] = emitter->size;
+    emit_32(emitter, 0);
+    EMIT(emitter, 0xFF, 0x24, 0xC1);             // jmp [rcx + rax * 8]
+
+    for(size_t i = 0; i < table->symbol_len; ++i) {
+        // The start of the rule is stored in place of the rel32 for now.
+        emitter->fixups[emitter->fixups_size++] = (struct Fixup){
+            .position = emitter->size,
+            .state = (StateId)-1
+        };
+        emit_rule(emitter, table, rules[i], i);
+    }
+}
+
+int compile_jit(struct JitProgram* const program, const struct TransitionTable* const table) {
+    const size_t states = table->states_size;
+    const size_t symbols = table->symbol_len;
+
+    // An upper bound of the size of the generated code.
+    const size_t state_size = 32 + (symbols <= MAX_COMPARISONS ? 11 : 8) * symbols + (16 + 2 * (5 + CALL_LENGTH)) * symbols;
+    const size_t size = 128 + states * state_size + 8 * (states + 1) + 8 * states * symbols + 16;
+
+    unsigned char* const code = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(code == MAP_FAILED) {
+        return 0;
+    }
+
+    // Every rule has at most two jumps to a state and an entry in a jump table.
+    struct Fixup* const fixups = malloc(sizeof(struct Fixup) * (3 * states * symbols + 1));
+    size_t* const labels = malloc(sizeof(size_t) * (states + 1));
+    size_t* const tables = malloc(sizeof(size_t) * (states + 1));
+    if(fixups == NULL || labels == NULL || tables == NULL) {
+        free(fixups);
+        free(labels);
+        free(tables);
+        munmap(code, size);
+        return 0;
+    }
+    size_t tables_size = 0;
+
+    struct Emitter emitter = {
+        .code = code,
+        .fixups = fixups
+    };
+
+    // The exit stores everything that changed and restores the registers.
+    const size_t exit = emitter.size;
+    EMIT(&emitter,
+        0x4C, 0x89, 0x6B, 0x10,   // mov [rbx + 16], r13
+        0x4C, 0x89, 0x7B, 0x18,   // mov [rbx + 24], r15
+        0x89, 0x43, 0x20,         // mov [rbx + 32], eax
+        0x41, 0x5F,               // pop r15
+        0x41, 0x5E,               // pop r14
+        0x41, 0x5D,               // pop r13
+        0x41, 0x5C,               // pop r12
+        0x5B,                     // pop rbx
+        0xC3                      // ret
+    );
+
+    // The entry saves the registers, loads the context and jumps to the current state.
+    const size_t entry = emitter.size;
+    EMIT(&emitter,
+        0x53,                     // push rbx
+        0x41, 0x54,               // push r12
+        0x41, 0x55,               // push r13
+        0x41, 0x56,               // push r14
+        0x41, 0x57,               // push r15
+        0x48, 0x89, 0xFB          // mov rbx, rdi
+    );
+    emit_reload(&emitter);
+    EMIT(&emitter,
+        0x4C, 0x8B, 0x7B, 0x18,   // mov r15, [rbx + 24]
+        0x8B, 0x43, 0x20,         // mov eax, [rbx + 32]
+        0x48, 0x8D, 0x0D          // lea rcx, [rip + rel32]
+    );
+    const size_t entry_table = emitter.size;
+    emit_32(&emitter, 0);
+    EMIT(&emitter, 0xFF, 0x24, 0xC1); // jmp [rcx + rax * 8]
+
+    for(StateId i = 0; i < states; ++i) {
+        labels[i] = emitter.size;
+        emit_state(&emitter, table, i, exit, tables, &tables_size);
+    }
+
+    labels[states] = emitter.size;
+    emit_exit(&emitter, table->halt, exit);
+
+    // The jump tables contain absolute addresses and have to be aligned.
+    emitter.size = (emitter.size + 7) & ~(size_t)7;
+
+    patch_32(&emitter, entry_table, (uint32_t)(emitter.size - (entry_table + 4)));
+    for(size_t i = 0; i <= states; ++i) {
+        emit_64(&emitter, (uint64_t)(uintptr_t)(code + labels[i]));
+    }
+
+    // Resolves the jumps to states and fills the jump tables of the states
+    // with the starts of the rules (in the order they were emitted).
+    size_t table_index = 0;
+    size_t table_entries = 0;
+    for(size_t i = 0; i < emitter.fixups_size; ++i) {
+        const struct Fixup fixup = emitter.fixups[i];
+
+        if(fixup.state != (StateId)-1) {
+            patch_32(&emitter, fixup.position, (uint32_t)(labels[fixup.state] - (fixup.position + 4)));
+            continue;
+        }
+
+        if(table_entries == 0) {
+            patch_32(&emitter, tables[table_index], (uint32_t)(emitter.size - (tables[table_index] + 4)));
+        }
+
+        emit_64(&emitter, (uint64_t)(uintptr_t)(code + fixup.position));
+
+        if(++table_entries == symbols) {
+            table_entries = 0;
+            ++table_index;
+        }
+    }
+
+    free(fixups);
+    free(labels);
+    free(tables);
+
+    if(mprotect(code, size, PROT_READ | PROT_EXEC) != 0) {
+        munmap(code, size);
+        return 0;
+    }
+
+    *program = (struct JitProgram){
+        .code = code,
+        .size = size,
+        .entry = code + entry
+    };
+
+    return 1;
+}
+
+void free_jit(struct JitProgram* const program) {
+    munmap(program->code, program->size);
+    program->code = NULL;
+}
+
+#else
+
+int compile_jit(struct JitProgram* const program, const struct TransitionTable* const table) {
+    (void)program;
+    (void)table;
+
+    return 0;
+}
+
+void free_jit(struct JitProgram* const program) {
+    (void)program;
+}
+
+#endif
+
+size_t run_jit(const struct JitProgram* const program, struct Tape* const tape, StateId* const state, const size_t max_iter) {
+    struct JitContext context = {
+        .content = tape->content,
+        .size = tape->size,
+        .cursor = tape->cursor,
+        .remaining = max_iter,
+        .state = *state,
+        .tape = tape
+    };
+
+    JitFunction function;
+    memcpy(&function, &program->entry, sizeof(function));
+    function(&context);
+
+    tape->cursor = context.cursor;
+    *state = context.state;
+
+    return max_iter - context.remaining;
+}
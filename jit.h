@@ -0,0 +1,31 @@
+#pragma once
+
+#include "table.h"
+
+/* The native code of a transition table.
+ * The code is only generated for x86-64 on unix-like systems.
+ */
+struct JitProgram {
+    unsigned char* code;
+    size_t size;
+
+    // The address of the function that is being called.
+    unsigned char* entry;
+};
+
+/* Generates x86-64 machine code for the transition table. Every state gets
+ * its own block of code that reads the symbol under the head and jumps
+ * directly to the code of the next state.
+ *
+ * @return 1 if it was successful and 0 if the JIT is not supported.
+ */
+int compile_jit(struct JitProgram* const program, const struct TransitionTable* const table);
+
+/* Runs the native code on the tape until the halt state is reached
+ * or `max_iter` steps have been executed.
+ *
+ * @return The amount of steps that were executed.
+ */
+size_t run_jit(const struct JitProgram* const program, struct Tape* const tape, StateId* const state, const size_t max_iter);
+
+void free_jit(struct JitProgram* const program);
@@ -1,144 +1,199 @@
 #include "lexer.h"
 #include "error.h"
 
-#include <assert.h>
 #include <ctype.h>
 #include <stdlib.h>
+#include <string.h>
 
-#define new_token(name) (struct Token){.type = name, .position = ftell(lexer->fptr)}
+#define new_token(name, start) (struct Token){.type = name, .position = start, .length = lexer->position - (start)}
 
 struct Lexer init_lexer(const char* const file_name) {
-    FILE* fptr = fopen(file_name, "r");
+    struct Lexer lexer = {
+        .file_name = file_name
+    };
 
-    if(fptr == NULL) {
+    if(!map_file(&lexer.source, file_name)) {
         return (struct Lexer){0};
     }
 
-    struct Lexer lexer = {
-        .fptr = fptr,
-        .file_name = file_name
-    };
+    lexer.lines_allocated = 1024;
+    lexer.lines = malloc(sizeof(size_t) * lexer.lines_allocated);
+    if(lexer.lines == NULL) {
+        out_of_memory();
+    }
+
+    // The first line starts at the beginning.
+    lexer.lines[0] = 0;
+    lexer.lines_size = 1;
 
     next_token(&lexer);
 
     return lexer;
 }
 
-void skip_whitespace(FILE* const fptr) {
-    int c;
-    while((c = getc(fptr)) != EOF && isspace(c));
-
-    ungetc(c, fptr);
+// Returns the next character without consuming it or EOF at the end of the source.
+static inline int peek(const struct Lexer* const lexer) {
+    return lexer->position < lexer->source.size ? (unsigned char)lexer->source.content[lexer->position] : EOF;
 }
 
-void skip_comment(FILE* const fptr) {
-    int c;
-    while((c = getc(fptr)) != EOF && c != '\n');
-}
+static void add_line(struct Lexer* const lexer, const size_t start) {
+    if(lexer->lines_size >= lexer->lines_allocated) {
+        lexer->lines_allocated *= 2;
+        lexer->lines = realloc(lexer->lines, sizeof(size_t) * lexer->lines_allocated);
 
-void skip_delimiter(FILE* const fptr) {
-    int c;
-    while((c = getc(fptr)) != EOF && c == '-');
-
-    ungetc(c, fptr);
-}
-
-char* get_identifier(FILE* const fptr, int c) {
-    size_t size = 16;
-    char* buf = calloc(size, sizeof(char));
-    if(buf ==  NULL) {
-        fprintf(stderr, "Couldn't allocate enough memory.\n");
-        exit(100);
+        if(lexer->lines == NULL) {
+            out_of_memory();
+        }
     }
 
-    buf[0] = c;
-
-    size_t i = 1;
-    for(; i < 255; ++i) {
-        c = getc(fptr);
+    lexer->lines[lexer->lines_size] = start;
+    ++lexer->lines_size;
+}
 
-        if(!isalnum(c) && c != '_') {
-            break;
+// Newlines can only be part of whitespace and comments, so only these have to add lines.
+static void skip_whitespace(struct Lexer* const lexer) {
+    while(lexer->position < lexer->source.size && isspace((unsigned char)lexer->source.content[lexer->position])) {
+        if(lexer->source.content[lexer->position] == '\n') {
+            add_line(lexer, lexer->position + 1);
         }
 
-        if(i >= size) {
-            size *= 2;
-            buf = realloc(buf, sizeof(char) * size);
+        ++lexer->position;
+    }
+}
 
-            if(buf ==  NULL) {
-                fprintf(stderr, "Couldn't allocate enough memory.\n");
-                exit(100);
-            }
-        }
+static void skip_comment(struct Lexer* const lexer) {
+    const char* const end = memchr(lexer->source.content + lexer->position, '\n', lexer->source.size - lexer->position);
 
-        buf[i] = c;
+    if(end == NULL) {
+        lexer->position = lexer->source.size;
+        return;
     }
 
-    if(i > 255) {
-        fprintf(stderr, "Identifiers cannot be larger than '255' characters long.");
+    lexer->position = (size_t)(end - lexer->source.content) + 1;
+    add_line(lexer, lexer->position);
+}
+
+// Skips everything up to the next character that can start a token.
+static void skip_unknown(struct Lexer* const lexer) {
+    int c;
+    while((c = peek(lexer)) != EOF && !isspace(c) && !isalnum(c) && strchr("#=,_{}-", c) == NULL) {
+        ++lexer->position;
     }
+}
 
-    buf[i] = '\0';
-    buf = realloc(buf, sizeof(char) * (i + 1));
-    
-    ungetc(c, fptr);
+static void skip_delimiter(struct Lexer* const lexer) {
+    while(peek(lexer) == '-') {
+        ++lexer->position;
+    }
+}
 
-    return buf;
+static void skip_identifier(struct Lexer* const lexer) {
+    int c;
+    while((c = peek(lexer)) != EOF && (isalnum(c) || c == '_')) {
+        ++lexer->position;
+    }
 }
 
 void next_token(struct Lexer* const lexer) {
     start:
-    skip_whitespace(lexer->fptr);
+    skip_whitespace(lexer);
 
     struct Token next;
 
-    int c = getc(lexer->fptr);
+    const size_t position = lexer->position;
+    const int c = peek(lexer);
+    ++lexer->position;
+
     switch (c) {
     case EOF:
-        next = (struct Token){.type = TOK_EOF};
+        lexer->position = position;
+        next = (struct Token){.type = TOK_EOF, .position = position};
         break;
 
     case '#':
         // This is a comment. It should not be returned as a token as it is completely useless for a parser
-        skip_comment(lexer->fptr);
+        skip_comment(lexer);
 
         goto start;
         
     case '=':
-        next = new_token(TOK_EQUALS);
+        next = new_token(TOK_EQUALS, position);
         break;
     case ',':
-        next = new_token(TOK_COMMA);
+        next = new_token(TOK_COMMA, position);
         break;
     case '_':
-        next = new_token(TOK_UNDERSCORE);
+        next = new_token(TOK_UNDERSCORE, position);
         break;
     case '{':
-        next = new_token(TOK_OPEN_CURLY);
+        next = new_token(TOK_OPEN_CURLY, position);
         break;
     case '}':
-        next = new_token(TOK_CLOSE_CURLY);
+        next = new_token(TOK_CLOSE_CURLY, position);
         break;
 
     case '-':
-        skip_delimiter(lexer->fptr);
+        skip_delimiter(lexer);
 
-        next = new_token(TOK_DELIMITER);
+        next = new_token(TOK_DELIMITER, position);
         break;
 
     default:
         if(isalpha(c) || isdigit(c)) {
-            next = new_token(TOK_IDENTIFIER);
-            next.content = get_identifier(lexer->fptr, c);
+            skip_identifier(lexer);
 
+            next = new_token(TOK_IDENTIFIER, position);
             break;
         }
 
-        print_parser_error(lexer->fptr, lexer->file_name, "Lexer Error", "Cannot decypher this token.");
-        exit(5);
+        // The error is reported, but the lexer continues with the next token, so that more errors can be found.
+        if(lexer->errors == 0) {
+            lexer->status = 5;
+        }
+        print_parser_error(lexer, position, "Lexer Error", "Cannot decypher this token.");
+
+        skip_unknown(lexer);
+        goto start;
     }
 
     lexer->curr_token = lexer->next_token;
     lexer->next_token = next;
 }
 
+size_t find_line(const struct Lexer* const lexer, const size_t position) {
+    // The last line that starts at or before the position
+    size_t low = 0;
+    size_t high = lexer->lines_size;
+
+    while(high - low > 1) {
+        const size_t middle = low + (high - low) / 2;
+
+        if(lexer->lines[middle] <= position) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+bool token_equals(const struct Lexer* const lexer, const struct Token* const token, const char* const string) {
+    return strncmp(lexer->source.content + token->position, string, token->length) == 0 && string[token->length] == '\0';
+}
+
+bool same_token(const struct Lexer* const lexer, const struct Token* const first, const struct Token* const second) {
+    return first->length == second->length
+        && memcmp(lexer->source.content + first->position, lexer->source.content + second->position, first->length) == 0;
+}
+
+char* token_string(const struct Lexer* const lexer, const struct Token* const token, struct Arena* const arena) {
+    return arena_string(arena, lexer->source.content + token->position, token->length);
+}
+
+void free_lexer(struct Lexer* const lexer) {
+    unmap_file(&lexer->source);
+
+    free(lexer->lines);
+    lexer->lines = NULL;
+}
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <stdbool.h>
 #include <stdio.h>
 
+#include "arena.h"
+#include "memory.h"
+
 enum TokenType {
     TOK_EOF = 0,
     TOK_IDENTIFIER,
@@ -13,20 +17,60 @@ enum TokenType {
     TOK_DELIMITER
 };
 
+/* A token does not own its content. It only refers
+ * to the part of the source where it was found.
+ */
 struct Token {
     enum TokenType type;
-    char* content;
+
     size_t position;
+    size_t length;
 };
 
 struct Lexer {
-    FILE* fptr;
+    struct MappedFile source;
+    // The position of the next character that has to be read
+    size_t position;
+
+    // The positions where the lines start, as far as the source has been read
+    size_t* lines;
+    size_t lines_size;
+    size_t lines_allocated;
+
     const char* file_name;
 
+    // The amount of errors that were reported and the exit code of the first one
+    size_t errors;
+    int status;
+
     struct Token curr_token;
-    struct Token next_token;   
+    struct Token next_token;
 };
 
-struct Lexer init_lexer(const char* const fileName);
+// The arguments for printing a token with "%.*s".
+#define TOKEN_FORMAT(lexer, token) (int)(token).length, (lexer)->source.content + (token).position
+
+/* Maps the whole file and reads the first token.
+ * If the file cannot be opened, the content of the source is NULL.
+ */
+struct Lexer init_lexer(const char* const file_name);
 
 void next_token(struct Lexer* const lexer);
+
+/* Finds the line of a position that was already read.
+ *
+ * @return The index of the line (starting at 0).
+ */
+size_t find_line(const struct Lexer* const lexer, const size_t position);
+
+bool token_equals(const struct Lexer* const lexer, const struct Token* const token, const char* const string);
+
+bool same_token(const struct Lexer* const lexer, const struct Token* const first, const struct Token* const second);
+
+/* Copies the content of the token into the arena.
+ *
+ * @return A null terminated string.
+ */
+char* token_string(const struct Lexer* const lexer, const struct Token* const token, struct Arena* const arena);
+
+void free_lexer(struct Lexer* const lexer);
@@ -0,0 +1,333 @@
+#include "lockstep.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "memory.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define LOCKSTEP_AVX2
+#endif
+
+#define LANES 16
+#define WORDS (LOCKSTEP_CELLS / 32)
+#define EMPTY SIZE_MAX
+
+/* A rule in the layout of the engine:
+ *
+ *   | next state | move + 1 (2 bits) | write symbol (1 bit) |
+ *
+ * The halt state has rules as well that keep the symbol and do not move,
+ * so that a lane that halted does not change until it gets the next table.
+ */
+typedef uint32_t LaneRule;
+
+#define LANE_RULE(next, move, write) ((LaneRule)(next) << 3 | (LaneRule)((move) + 1) << 1 | (LaneRule)(write))
+
+// Lanes without a table stay in this state, which never halts.
+#define IDLE_STATE 0
+
+struct Lanes {
+    const struct TransitionTable* tables;
+    size_t size;
+    // The next table in the queue
+    size_t next;
+    size_t max_iter;
+    struct LockstepResult* results;
+
+    // The rules of all tables after each other, followed by the rules of idle lanes
+    LaneRule* rules;
+    uint32_t* offsets;
+    size_t active;
+
+    // Everything that every step needs, one element per lane
+    uint32_t state[LANES];
+    uint32_t head[LANES];
+    uint32_t word[LANES];
+    uint32_t base[LANES];
+    uint32_t halt[LANES];
+    uint32_t budget[LANES];
+
+    // The table of each lane, the steps it has left beyond `budget`
+    // and which word of the tape is in `word`
+    size_t machine[LANES];
+    size_t left[LANES];
+    uint32_t index[LANES];
+
+    uint32_t words[LANES][WORDS];
+};
+
+int lockstep_supported(const struct TransitionTable* const table) {
+    return table->symbol_len == 2;
+}
+
+static int move_of(const enum Direction direction) {
+    switch(direction) {
+    case LEFT:
+        return -1;
+    case RIGHT:
+        return 1;
+    case STAY:
+        break;
+    }
+
+    return 0;
+}
+
+/* Collects the rules of all tables.
+ *
+ * @return The offset of the rules for idle lanes.
+ */
+static uint32_t build_rules(struct Lanes* const lanes) {
+    lanes->offsets = malloc(sizeof(uint32_t) * (lanes->size > 0 ? lanes->size : 1));
+    if(lanes->offsets == NULL) {
+        out_of_memory();
+    }
+
+    size_t total = 0;
+    for(size_t i = 0; i < lanes->size; ++i) {
+        lanes->offsets[i] = (uint32_t)total;
+        total += (lanes->tables[i].states_size + 1) * 2;
+    }
+
+    lanes->rules = malloc(sizeof(LaneRule) * (total + 2));
+    if(lanes->rules == NULL) {
+        out_of_memory();
+    }
+
+    for(size_t i = 0; i < lanes->size; ++i) {
+        const struct TransitionTable* const table = &lanes->tables[i];
+        LaneRule* const rules = lanes->rules + lanes->offsets[i];
+
+        for(size_t j = 0; j < table->states_size * 2; ++j) {
+            const PackedRule rule = table->rules[j];
+            rules[j] = LANE_RULE(RULE_NEXT(table, rule), move_of(RULE_DIRECTION(table, rule)), RULE_SYMBOL(table, rule));
+        }
+
+        rules[table->states_size * 2] = LANE_RULE(table->halt, 0, 0);
+        rules[table->states_size * 2 + 1] = LANE_RULE(table->halt, 0, 1);
+    }
+
+    lanes->rules[total] = LANE_RULE(IDLE_STATE, 0, 0);
+    lanes->rules[total + 1] = LANE_RULE(IDLE_STATE, 0, 1);
+
+    return (uint32_t)total;
+}
+
+// The budget of a lane only has 32 bits, the rest is kept in `left`.
+static void take_budget(struct Lanes* const lanes, const size_t lane, const size_t steps) {
+    const size_t budget = steps < UINT32_MAX ? steps : UINT32_MAX;
+
+    lanes->budget[lane] = (uint32_t)budget;
+    lanes->left[lane] = steps - budget;
+}
+
+// Puts the next table of the queue into the lane or makes it idle.
+static void fill_lane(struct Lanes* const lanes, const size_t lane, const uint32_t idle) {
+    memset(lanes->words[lane], 0, sizeof(lanes->words[lane]));
+    lanes->head[lane] = LOCKSTEP_CELLS / 2;
+    lanes->index[lane] = lanes->head[lane] / 32;
+    lanes->word[lane] = 0;
+
+    // Tables that start in the halt state never get a lane.
+    while(lanes->next < lanes->size && lanes->tables[lanes->next].start == lanes->tables[lanes->next].halt) {
+        lanes->results[lanes->next++] = (struct LockstepResult){.status = LOCKSTEP_HALTED};
+    }
+
+    if(lanes->next >= lanes->size) {
+        lanes->machine[lane] = EMPTY;
+        lanes->state[lane] = IDLE_STATE;
+        lanes->base[lane] = idle;
+        lanes->halt[lane] = UINT32_MAX;
+        take_budget(lanes, lane, UINT32_MAX);
+        return;
+    }
+
+    const size_t machine = lanes->next++;
+    const struct TransitionTable* const table = &lanes->tables[machine];
+
+    lanes->machine[lane] = machine;
+    lanes->state[lane] = table->start;
+    lanes->base[lane] = lanes->offsets[machine];
+    lanes->halt[lane] = table->halt;
+    take_budget(lanes, lane, lanes->max_iter);
+}
+
+static void retire_lane(struct Lanes* const lanes, const size_t lane, const enum LockstepStatus status, const uint32_t idle) {
+    const size_t machine = lanes->machine[lane];
+
+    lanes->results[machine] = (struct LockstepResult){
+        .status = status,
+        .steps = lanes->max_iter - lanes->left[lane] - lanes->budget[lane]
+    };
+
+    fill_lane(lanes, lane, idle);
+
+    if(lanes->machine[lane] == EMPTY) {
+        --lanes->active;
+    }
+}
+
+/* Handles a lane after a step that halted it, used up its budget or moved
+ * its head onto another word of the tape.
+ */
+static void handle_lane(struct Lanes* const lanes, const size_t lane, const uint32_t idle) {
+    if(lanes->machine[lane] == EMPTY) {
+        take_budget(lanes, lane, UINT32_MAX);
+        return;
+    }
+
+    if(lanes->state[lane] == lanes->halt[lane]) {
+        retire_lane(lanes, lane, LOCKSTEP_HALTED, idle);
+        return;
+    }
+
+    if(lanes->budget[lane] == 0) {
+        if(lanes->left[lane] == 0) {
+            retire_lane(lanes, lane, LOCKSTEP_BUDGET, idle);
+            return;
+        }
+        take_budget(lanes, lane, lanes->left[lane]);
+    }
+
+    const uint32_t index = lanes->head[lane] / 32;
+    if(index != lanes->index[lane]) {
+        // Moving left of the first cell wraps around, so this covers both ends.
+        if(index >= WORDS) {
+            retire_lane(lanes, lane, LOCKSTEP_OVERFLOW, idle);
+            return;
+        }
+
+        lanes->words[lane][lanes->index[lane]] = lanes->word[lane];
+        lanes->index[lane] = index;
+        lanes->word[lane] = lanes->words[lane][index];
+    }
+}
+
+static void run_scalar(struct Lanes* const lanes, const uint32_t idle) {
+    const LaneRule* const rules = lanes->rules;
+
+    while(lanes->active > 0) {
+        for(size_t lane = 0; lane < LANES; ++lane) {
+            const uint32_t shift = lanes->head[lane] % 32;
+            const uint32_t bit = (lanes->word[lane] >> shift) & 1;
+            const LaneRule rule = rules[lanes->base[lane] + lanes->state[lane] * 2 + bit];
+            const uint32_t head = lanes->head[lane] + ((rule >> 1) & 3) - 1;
+
+            lanes->word[lane] = (lanes->word[lane] & ~((uint32_t)1 << shift)) | ((rule & 1) << shift);
+            lanes->state[lane] = rule >> 3;
+            --lanes->budget[lane];
+
+            const bool crossed = head / 32 != lanes->head[lane] / 32;
+            lanes->head[lane] = head;
+
+            if(crossed || lanes->state[lane] == lanes->halt[lane] || lanes->budget[lane] == 0) {
+                handle_lane(lanes, lane, idle);
+            }
+        }
+    }
+}
+
+#ifdef LOCKSTEP_AVX2
+// One step of the eight lanes in the vectors.
+#define STEP_AVX2(state, head, word, budget, base, halt, attention) do { \
+    const __m256i shift = _mm256_and_si256(head, thirty_one); \
+    const __m256i bit = _mm256_and_si256(_mm256_srlv_epi32(word, shift), one); \
+    const __m256i index = _mm256_add_epi32(_mm256_add_epi32(base, _mm256_slli_epi32(state, 1)), bit); \
+    const __m256i rule = _mm256_i32gather_epi32(rules, index, 4); \
+    const __m256i clear = _mm256_andnot_si256(_mm256_sllv_epi32(one, shift), word); \
+    word = _mm256_or_si256(clear, _mm256_sllv_epi32(_mm256_and_si256(rule, one), shift)); \
+    const __m256i moved = _mm256_add_epi32(head, _mm256_sub_epi32(_mm256_and_si256(_mm256_srli_epi32(rule, 1), three), one)); \
+    state = _mm256_srli_epi32(rule, 3); \
+    budget = _mm256_sub_epi32(budget, one); \
+    const __m256i crossed = _mm256_xor_si256(_mm256_srli_epi32(moved, 5), _mm256_srli_epi32(head, 5)); \
+    head = moved; \
+    attention = _mm256_or_si256( \
+        _mm256_or_si256(_mm256_cmpeq_epi32(state, halt), _mm256_cmpeq_epi32(budget, zero)), \
+        _mm256_xor_si256(_mm256_cmpeq_epi32(crossed, zero), _mm256_set1_epi32(-1)) \
+    ); \
+} while(0)
+
+__attribute__((target("avx2")))
+static void run_avx2(struct Lanes* const lanes, const uint32_t idle) {
+    const int* const rules = (const int*)lanes->rules;
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i three = _mm256_set1_epi32(3);
+    const __m256i thirty_one = _mm256_set1_epi32(31);
+    const __m256i zero = _mm256_setzero_si256();
+
+    while(lanes->active > 0) {
+        // Two vectors are stepped at once, so that one can go on while the other waits for its rules.
+        __m256i state[2], head[2], word[2], budget[2], base[2], halt[2], attention[2];
+        for(int i = 0; i < 2; ++i) {
+            state[i] = _mm256_loadu_si256((const __m256i*)(lanes->state + i * 8));
+            head[i] = _mm256_loadu_si256((const __m256i*)(lanes->head + i * 8));
+            word[i] = _mm256_loadu_si256((const __m256i*)(lanes->word + i * 8));
+            budget[i] = _mm256_loadu_si256((const __m256i*)(lanes->budget + i * 8));
+            base[i] = _mm256_loadu_si256((const __m256i*)(lanes->base + i * 8));
+            halt[i] = _mm256_loadu_si256((const __m256i*)(lanes->halt + i * 8));
+        }
+
+        int mask = 0;
+        while(mask == 0) {
+            STEP_AVX2(state[0], head[0], word[0], budget[0], base[0], halt[0], attention[0]);
+            STEP_AVX2(state[1], head[1], word[1], budget[1], base[1], halt[1], attention[1]);
+
+            mask = _mm256_movemask_ps(_mm256_castsi256_ps(attention[0]))
+                 | _mm256_movemask_ps(_mm256_castsi256_ps(attention[1])) << 8;
+        }
+
+        for(int i = 0; i < 2; ++i) {
+            _mm256_storeu_si256((__m256i*)(lanes->state + i * 8), state[i]);
+            _mm256_storeu_si256((__m256i*)(lanes->head + i * 8), head[i]);
+            _mm256_storeu_si256((__m256i*)(lanes->word + i * 8), word[i]);
+            _mm256_storeu_si256((__m256i*)(lanes->budget + i * 8), budget[i]);
+        }
+
+        while(mask != 0) {
+            const int lane = __builtin_ctz(mask);
+            handle_lane(lanes, lane, idle);
+            mask &= mask - 1;
+        }
+    }
+}
+#endif
+
+void run_lockstep(const struct TransitionTable* const tables, const size_t size, const size_t max_iter, struct LockstepResult* const results) {
+    struct Lanes* const lanes = calloc(1, sizeof(struct Lanes));
+    if(lanes == NULL) {
+        out_of_memory();
+    }
+
+    lanes->tables = tables;
+    lanes->size = size;
+    lanes->max_iter = max_iter;
+    lanes->results = results;
+
+    const uint32_t idle = build_rules(lanes);
+
+    for(size_t lane = 0; lane < LANES; ++lane) {
+        fill_lane(lanes, lane, idle);
+
+        if(lanes->machine[lane] != EMPTY) {
+            ++lanes->active;
+        }
+    }
+
+#ifdef LOCKSTEP_AVX2
+    if(__builtin_cpu_supports("avx2")) {
+        run_avx2(lanes, idle);
+    } else {
+        run_scalar(lanes, idle);
+    }
+#else
+    run_scalar(lanes, idle);
+#endif
+
+    free(lanes->rules);
+    free(lanes->offsets);
+    free(lanes);
+}
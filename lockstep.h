@@ -0,0 +1,34 @@
+#pragma once
+
+#include "table.h"
+
+// The cells around the start of the head that a machine can use in the lockstep engine.
+#define LOCKSTEP_CELLS 8192
+
+enum LockstepStatus {
+    LOCKSTEP_HALTED,
+    LOCKSTEP_BUDGET,
+    // The head left the cells of the engine, so the machine has to be run on a normal tape.
+    LOCKSTEP_OVERFLOW
+};
+
+struct LockstepResult {
+    enum LockstepStatus status;
+    size_t steps;
+};
+
+// If the table has two symbols, so that it can be run by the lockstep engine.
+int lockstep_supported(const struct TransitionTable* const table);
+
+/* Runs all of the tables from a blank tape with one machine in every lane of a
+ * vector: The states, heads and the words of the tapes under the heads are kept
+ * in separate arrays and all of the lanes do a step together. The rules are
+ * gathered from one array with the rules of all tables and a lane that halted,
+ * used up its budget or left its cells gets the next table of the queue.
+ * Only lanes whose heads move onto another word of their tape are handled
+ * one by one. Two vectors are stepped at once to hide the latency of the gathers.
+ * Without AVX2 the lanes are stepped one after another.
+ *
+ * The results are stored in the same order as the tables.
+ */
+void run_lockstep(const struct TransitionTable* const tables, const size_t size, const size_t max_iter, struct LockstepResult* const results);
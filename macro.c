@@ -0,0 +1,417 @@
+#include "macro.h"
+
+#include <stdio.h>
+
+#include "memory.h"
+
+enum Exit {
+    EXIT_LEFT,
+    EXIT_RIGHT,
+    EXIT_HALT,
+    // The steps ran out before the head left the block.
+    EXIT_STOPPED
+};
+
+struct MacroTransition {
+    // The key
+    Block block;
+    StateId state;
+    bool from_right;
+    bool used;
+
+    // The result
+    enum Exit exit;
+    Block new_block;
+    StateId new_state;
+    size_t position;
+    size_t steps;
+};
+
+#define CELL_MASK(table) (((Block)1 << (table)->symbol_bits) - 1)
+
+static Symbol get_cell(const struct TransitionTable* const table, const Block block, const size_t position) {
+    return (Symbol)((block >> (position * table->symbol_bits)) & CELL_MASK(table));
+}
+
+static Block set_cell(const struct TransitionTable* const table, const Block block, const size_t position, const Symbol symbol) {
+    const unsigned int shift = position * table->symbol_bits;
+
+    return (block & ~(CELL_MASK(table) << shift)) | ((Block)symbol << shift);
+}
+
+static void push(struct BlockStack* const stack, const Block block, const size_t length, const Block blank) {
+    if(stack->size > 0 && stack->runs[stack->size - 1].block == block) {
+        stack->runs[stack->size - 1].length += length;
+        return;
+    }
+
+    // The blanks at the end of the tape are implicit.
+    if(stack->size == 0 && block == blank) {
+        return;
+    }
+
+    if(stack->size >= stack->allocated) {
+        stack->allocated = stack->allocated == 0 ? 16 : stack->allocated * 2;
+        stack->runs = realloc(stack->runs, sizeof(struct BlockRun) * stack->allocated);
+
+        if(stack->runs == NULL) {
+            out_of_memory();
+        }
+    }
+
+    stack->runs[stack->size] = (struct BlockRun){
+        .block = block,
+        .length = length
+    };
+    ++stack->size;
+}
+
+/* Removes `length` blocks from the nearest run and returns the block after them.
+ * The run has to contain at least `length` blocks.
+ */
+static Block pop(struct BlockStack* const stack, const size_t length, const Block blank) {
+    if(stack->size == 0) {
+        return blank;
+    }
+
+    struct BlockRun* run = &stack->runs[stack->size - 1];
+    run->length -= length;
+
+    if(run->length == 0) {
+        --stack->size;
+
+        if(stack->size == 0) {
+            return blank;
+        }
+
+        run = &stack->runs[stack->size - 1];
+    }
+
+    const Block block = run->block;
+    if(--run->length == 0) {
+        --stack->size;
+    }
+
+    return block;
+}
+
+int init_macro_machine(struct MacroMachine* const macro, const struct TransitionTable* const table, const struct Tape* const tape, const size_t block_size) {
+    if(block_size == 0 || block_size * table->symbol_bits > sizeof(Block) * 8) {
+        return 0;
+    }
+
+    *macro = (struct MacroMachine){
+        .table = table,
+        .block_size = block_size
+    };
+
+    for(size_t i = 0; i < block_size; ++i) {
+        macro->blank = set_cell(table, macro->blank, i, tape->def);
+    }
+
+    // The blocks are aligned so that the head is at the start of a block.
+    const long cursor = tape->cursor;
+    const long size = tape->size;
+
+    for(long start = cursor - (long)block_size * ((cursor + block_size - 1) / block_size); start < cursor; start += block_size) {
+        Block block = macro->blank;
+        for(size_t i = 0; i < block_size; ++i) {
+            const long cell = start + i;
+            if(cell >= 0) {
+                block = set_cell(table, block, i, tape->content[cell]);
+            }
+        }
+
+        push(&macro->left, block, 1, macro->blank);
+    }
+
+    const long blocks_right = (size - cursor + block_size - 1) / block_size;
+    for(long start = cursor + (blocks_right - 1) * (long)block_size; start >= cursor; start -= block_size) {
+        Block block = macro->blank;
+        for(size_t i = 0; i < block_size && start + (long)i < size; ++i) {
+            block = set_cell(table, block, i, tape->content[start + i]);
+        }
+
+        if(start == cursor) {
+            macro->current = block;
+        } else {
+            push(&macro->right, block, 1, macro->blank);
+        }
+    }
+
+    return 1;
+}
+
+/* Simulates the original machine inside of a single block.
+ * It stops after `limit` steps even if the head did not leave the block.
+ */
+static struct MacroTransition simulate(const struct MacroMachine* const macro, const Block block, const StateId state, const bool from_right, const size_t limit) {
+    const struct TransitionTable* const table = macro->table;
+
+    struct MacroTransition transition = {
+        .block = block,
+        .state = state,
+        .from_right = from_right,
+        .used = true
+    };
+
+    Block current = block;
+    StateId current_state = state;
+    long position = from_right ? (long)macro->block_size - 1 : 0;
+    size_t steps = 0;
+
+    enum Exit exit = EXIT_STOPPED;
+    while(steps < limit) {
+        if(current_state == table->halt) {
+            exit = EXIT_HALT;
+            break;
+        }
+
+        const PackedRule rule = table->rules[current_state * table->symbol_len + get_cell(table, current, position)];
+        current = set_cell(table, current, position, RULE_SYMBOL(table, rule));
+        current_state = RULE_NEXT(table, rule);
+        ++steps;
+
+        const enum Direction direction = RULE_DIRECTION(table, rule);
+        if(direction == LEFT && --position < 0) {
+            exit = EXIT_LEFT;
+            break;
+        }
+        if(direction == RIGHT && ++position >= (long)macro->block_size) {
+            exit = EXIT_RIGHT;
+            break;
+        }
+    }
+
+    if(exit == EXIT_STOPPED && current_state == table->halt) {
+        exit = EXIT_HALT;
+    }
+
+    transition.exit = exit;
+    transition.new_block = current;
+    transition.new_state = current_state;
+    transition.position = position < 0 ? 0 : (size_t)position;
+    transition.steps = steps;
+
+    return transition;
+}
+
+static size_t hash_key(const Block block, const StateId state, const bool from_right) {
+    uint64_t hash = block * 0x9E3779B97F4A7C15ull;
+    hash ^= ((uint64_t)state << 1 | from_right) * 0xC2B2AE3D27D4EB4Full;
+    hash ^= hash >> 29;
+
+    return (size_t)hash;
+}
+
+static struct MacroTransition* find_slot(struct MacroTransition* const transitions, const size_t allocated, const Block block, const StateId state, const bool from_right) {
+    size_t i = hash_key(block, state, from_right) & (allocated - 1);
+
+    while(transitions[i].used && (transitions[i].block != block || transitions[i].state != state || transitions[i].from_right != from_right)) {
+        i = (i + 1) & (allocated - 1);
+    }
+
+    return &transitions[i];
+}
+
+static void insert_transition(struct MacroMachine* const macro, const struct MacroTransition transition) {
+    if((macro->transitions_size + 1) * 2 > macro->transitions_allocated) {
+        const size_t allocated = macro->transitions_allocated == 0 ? 1024 : macro->transitions_allocated * 2;
+        struct MacroTransition* const transitions = calloc(allocated, sizeof(struct MacroTransition));
+
+        if(transitions == NULL) {
+            out_of_memory();
+        }
+
+        for(size_t i = 0; i < macro->transitions_allocated; ++i) {
+            const struct MacroTransition old = macro->transitions[i];
+            if(old.used) {
+                *find_slot(transitions, allocated, old.block, old.state, old.from_right) = old;
+            }
+        }
+
+        free(macro->transitions);
+        macro->transitions = transitions;
+        macro->transitions_allocated = allocated;
+    }
+
+    *find_slot(macro->transitions, macro->transitions_allocated, transition.block, transition.state, transition.from_right) = transition;
+    ++macro->transitions_size;
+}
+
+size_t run_macro(struct MacroMachine* const macro, StateId* const state, const size_t max_iter) {
+    const StateId halt = macro->table->halt;
+
+    StateId current_state = *state;
+    bool from_right = macro->from_right;
+    size_t count = 0;
+
+    while(current_state != halt && count < max_iter) {
+        const size_t remaining = max_iter - count;
+
+        struct MacroTransition transition;
+        const struct MacroTransition* found = macro->transitions == NULL ? NULL
+            : find_slot(macro->transitions, macro->transitions_allocated, macro->current, current_state, from_right);
+
+        if(found != NULL && found->used && found->steps <= remaining) {
+            transition = *found;
+        } else {
+            transition = simulate(macro, macro->current, current_state, from_right, remaining);
+
+            // A stopped transition depends on the limit and cannot be reused.
+            if(transition.exit != EXIT_STOPPED && (found == NULL || !found->used)) {
+                insert_transition(macro, transition);
+            }
+        }
+
+        if(transition.exit == EXIT_HALT || transition.exit == EXIT_STOPPED) {
+            macro->current = transition.new_block;
+            macro->position = transition.position;
+            current_state = transition.new_state;
+            count += transition.steps;
+            break;
+        }
+
+        const bool to_right = transition.exit == EXIT_RIGHT;
+        struct BlockStack* const behind = to_right ? &macro->left : &macro->right;
+        struct BlockStack* const ahead = to_right ? &macro->right : &macro->left;
+
+        // If the head leaves the block on the other side in the same state,
+        // the same will happen for all of the same blocks in front of it.
+        size_t repeat = 1;
+        if(transition.new_state == current_state && from_right != to_right) {
+            size_t same = 0;
+            if(ahead->size > 0) {
+                if(ahead->runs[ahead->size - 1].block == macro->current) {
+                    same = ahead->runs[ahead->size - 1].length;
+                }
+            } else if(macro->current == macro->blank) {
+                same = SIZE_MAX - 1;
+            }
+
+            const size_t possible = remaining / transition.steps;
+            repeat = same + 1 < possible ? same + 1 : possible;
+        }
+
+        push(behind, transition.new_block, repeat, macro->blank);
+        macro->current = pop(ahead, repeat - 1, macro->blank);
+        macro->position = to_right ? 0 : macro->block_size - 1;
+
+        current_state = transition.new_state;
+        from_right = !to_right;
+        count += transition.steps * repeat;
+    }
+
+    *state = current_state;
+    macro->from_right = from_right;
+
+    return count;
+}
+
+static void fill_window(const struct MacroMachine* const macro, Symbol* const cells, const size_t amount, const struct BlockStack* const stack, const bool to_right) {
+    size_t filled = 0;
+
+    for(size_t i = stack->size; i > 0 && filled < amount; --i) {
+        const struct BlockRun run = stack->runs[i - 1];
+
+        for(size_t j = 0; j < run.length && filled < amount; ++j) {
+            for(size_t k = 0; k < macro->block_size && filled < amount; ++k) {
+                cells[filled++] = get_cell(macro->table, run.block, to_right ? k : macro->block_size - 1 - k);
+            }
+        }
+    }
+
+    for(size_t k = 0; filled < amount; ++filled, ++k) {
+        cells[filled] = get_cell(macro->table, macro->blank, k % macro->block_size);
+    }
+}
+
+struct Tape macro_tape_window(const struct MacroMachine* const macro, const size_t width) {
+    const size_t before = width / 2;
+    const size_t after = width - before - 1;
+
+    Symbol* const content = malloc(sizeof(Symbol) * width);
+    Symbol* const left = malloc(sizeof(Symbol) * (before + macro->block_size));
+    Symbol* const right = malloc(sizeof(Symbol) * (after + macro->block_size));
+
+    if(content == NULL || left == NULL || right == NULL) {
+        out_of_memory();
+    }
+
+    // Both sides are filled from the head outwards starting with the rest of the current block.
+    size_t left_len = 0;
+    for(size_t i = macro->position; i > 0; --i) {
+        left[left_len++] = get_cell(macro->table, macro->current, i - 1);
+    }
+    if(left_len < before) {
+        fill_window(macro, left + left_len, before - left_len, &macro->left, false);
+    }
+
+    size_t right_len = 0;
+    for(size_t i = macro->position + 1; i < macro->block_size; ++i) {
+        right[right_len++] = get_cell(macro->table, macro->current, i);
+    }
+    if(right_len < after) {
+        fill_window(macro, right + right_len, after - right_len, &macro->right, true);
+    }
+
+    for(size_t i = 0; i < before; ++i) {
+        content[i] = left[before - 1 - i];
+    }
+    content[before] = get_cell(macro->table, macro->current, macro->position);
+    for(size_t i = 0; i < after; ++i) {
+        content[before + 1 + i] = right[i];
+    }
+
+    free(left);
+    free(right);
+
+    const Symbol def = get_cell(macro->table, macro->blank, 0);
+    struct Tape window = init_tape_full(def, content, width);
+    window.cursor = before;
+
+    return window;
+}
+
+static void export_block(struct Exporter* const exporter, const struct MacroMachine* const macro, const Block block, const size_t length) {
+    const Symbol first = get_cell(macro->table, block, 0);
+
+    size_t same = 1;
+    while(same < macro->block_size && get_cell(macro->table, block, same) == first) {
+        ++same;
+    }
+
+    // A run of blocks that only contain one symbol is a single run of cells.
+    if(same == macro->block_size) {
+        export_run(exporter, first, length * macro->block_size);
+        return;
+    }
+
+    for(size_t i = 0; i < length; ++i) {
+        for(size_t k = 0; k < macro->block_size; ++k) {
+            export_run(exporter, get_cell(macro->table, block, k), 1);
+        }
+    }
+}
+
+void export_macro_tape(struct Exporter* const exporter, const struct MacroMachine* const macro) {
+    for(size_t i = 0; i < macro->left.size; ++i) {
+        export_block(exporter, macro, macro->left.runs[i].block, macro->left.runs[i].length);
+    }
+
+    export_block(exporter, macro, macro->current, 1);
+
+    for(size_t i = macro->right.size; i > 0; --i) {
+        export_block(exporter, macro, macro->right.runs[i - 1].block, macro->right.runs[i - 1].length);
+    }
+}
+
+void free_macro_machine(struct MacroMachine* const macro) {
+    free(macro->transitions);
+    free(macro->left.runs);
+    free(macro->right.runs);
+
+    macro->transitions = NULL;
+    macro->left = (struct BlockStack){0};
+    macro->right = (struct BlockStack){0};
+}
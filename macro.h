@@ -0,0 +1,75 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "export.h"
+#include "table.h"
+
+typedef uint64_t Block;
+
+struct BlockRun {
+    Block block;
+    size_t length;
+};
+
+struct BlockStack {
+    struct BlockRun* runs;
+    size_t size;
+    size_t allocated;
+};
+
+struct MacroTransition;
+
+/* A macro machine treats `block_size` cells as a single symbol (a block).
+ * The head always enters a block from one of its sides and the machine
+ * computes what happens inside of the block until the head leaves it.
+ * These transitions are computed lazily from the transition table and
+ * memoized, so that every combination is only simulated once.
+ *
+ * The tape is stored as runs of the same block on both sides of the head
+ * (like the `RunTape`). If a transition leaves the block on the opposite side
+ * in the same state, it is applied to the whole run of the same blocks at once.
+ */
+struct MacroMachine {
+    const struct TransitionTable* table;
+
+    size_t block_size;
+    Block blank;
+
+    struct MacroTransition* transitions;
+    size_t transitions_size;
+    size_t transitions_allocated;
+
+    struct BlockStack left;
+    struct BlockStack right;
+
+    Block current;
+    // The position of the head inside of the current block.
+    size_t position;
+    bool from_right;
+};
+
+/* Creates a macro machine from the tape with the head at the
+ * left side of the first block.
+ *
+ * @return 1 if it was successful and 0 if the blocks cannot contain `block_size` cells.
+ */
+int init_macro_machine(struct MacroMachine* const macro, const struct TransitionTable* const table, const struct Tape* const tape, const size_t block_size);
+
+/* Runs the macro machine until the halt state is reached
+ * or `max_iter` steps have been executed.
+ *
+ * @return The amount of steps (of the original machine) that were executed.
+ */
+size_t run_macro(struct MacroMachine* const macro, StateId* const state, const size_t max_iter);
+
+/* Converts the cells around the head into a normal tape
+ * with `width / 2` cells on the left of the head.
+ */
+struct Tape macro_tape_window(const struct MacroMachine* const macro, const size_t width);
+
+// Exports the cells of the whole tape from left to right.
+void export_macro_tape(struct Exporter* const exporter, const struct MacroMachine* const macro);
+
+void free_macro_machine(struct MacroMachine* const macro);
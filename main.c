@@ -1,16 +1,60 @@
 #include <ctype.h>
 #include <errno.h>
 #include <limits.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #include "turingmachine.h"
 #include "parser.h"
+#include "compiled.h"
+#include "tapefile.h"
+#include "export.h"
+#include "table.h"
+#include "macro.h"
+#include "emit.h"
+#include "jit.h"
+#include "threaded.h"
+#include "cycle.h"
+#include "decide.h"
+#include "batch.h"
+#include "inputs.h"
+#include "enumerate.h"
+#include "compact.h"
+#include "checkpoint.h"
 
 struct Arguments {
     size_t view_width;
     size_t max_iter;
+    bool quiet;
+    bool rle;
+    bool jit;
+    bool threaded;
+    bool benchmark;
+    bool cycles;
+    bool decide;
+    bool batch;
+    bool enumerate;
+    bool machines;
+    size_t threads;
+    size_t block_size;
+    const char* emit_c;
+    const char* compile;
+    bool cache;
+    const char* tape;
+    const char* raw_tape;
+    const char* inputs;
+    const char* undecided;
+    const char* range;
+    const char* checkpoint;
+    size_t checkpoint_every;
+    const char* resume;
+    // The steps that were done before the checkpoint that is resumed
+    size_t steps;
+    const char* export;
+    enum ExportFormat export_format;
 };
 
 void print_machine(const struct TuringMachine* const machine, const size_t view_width){
@@ -51,9 +95,9 @@ typedef enum {
     STR2INT_INCONVERTIBLE
 } str2int_errno;
 
-/* Convert string s to int out.
+/* Convert string s to long out.
  *
- * @param[out] out The converted int. Cannot be NULL.
+ * @param[out] out The converted long. Cannot be NULL.
  *
  * @param[in] s Input string to be converted.
  *
@@ -70,16 +114,17 @@ typedef enum {
  *
  * @return Indicates if the operation succeeded, or why it failed.
  */
-str2int_errno str2int(int *out, const char *s, int base) {
+str2int_errno str2long(long *out, const char *s, int base) {
     char *end;
     if (s[0] == '\0' || isspace(s[0]))
         return STR2INT_INCONVERTIBLE;
     errno = 0;
     long l = strtol(s, &end, base);
-    /* Both checks are needed because INT_MAX == LONG_MAX is possible. */
-    if (l > INT_MAX || (errno == ERANGE && l == LONG_MAX))
+    /* Values outside of long are clamped by strtol and set ERANGE,
+     * trailing characters are left in end. Both are rejected. */
+    if (errno == ERANGE && l == LONG_MAX)
         return STR2INT_OVERFLOW;
-    if (l < INT_MIN || (errno == ERANGE && l == LONG_MIN))
+    if (errno == ERANGE && l == LONG_MIN)
         return STR2INT_UNDERFLOW;
     if (*end != '\0')
         return STR2INT_INCONVERTIBLE;
@@ -91,9 +136,64 @@ void print_help(void) {
     printf(
         "\033[1;4mTAU Help\033[0m\n\n"
         "\033[3;4mGeneral command syntax:\033[0m\n"
-        "  ./tau <filename>\n\n"
+        "  ./tau <filename>\n"
+        "  ./tau <directory|manifest> --batch\n"
+        "  ./tau <states>,<symbols> --enumerate\n"
+        "  ./tau <machines> --machines\n\n"
         "\033[3;4mFlags:\033[0m\n"
         "  --help          Prints this help message.\n"
+        "  --quiet         Only prints the final state, tape and step count.\n"
+        "  --rle           Runs the machine on a run-length encoded tape (implies --quiet).\n"
+        "  --jit           Runs the machine as native code if it is supported (implies --quiet).\n"
+        "  --threaded      Runs the machine with the threaded interpreter (implies --quiet).\n"
+        "  --cycles        Stops as soon as the machine provably repeats its configuration,\n"
+        "                  in place or shifted (implies --quiet).\n"
+        "  --decide        Tries to prove that the machine never halts from its rules\n"
+        "                  before it is run and only runs it if that is not possible.\n"
+        "  --batch         Runs every `.tau` file of the directory or every file that is\n"
+        "                  listed in the manifest and prints one line per machine:\n"
+        "                  path, result (halted/looped/budget/error), steps, tape size.\n"
+        "  --inputs        Runs the machine once for every line of the given file, which\n"
+        "                  contains an initial tape like --tape, and prints one line\n"
+        "                  per input: line, result, steps, final tape.\n"
+        "  --enumerate     Runs every machine with the given amount of states and symbols\n"
+        "                  (in tree normal form) and prints how many halted, looped or used\n"
+        "                  up --max-iter and the machines that halted after the most steps.\n"
+        "  --undecided     Writes the machines of --enumerate that could not be decided\n"
+        "                  into the given file.\n"
+        "  --machines      Runs every machine of a file with one machine per line in the\n"
+        "                  compact notation (`1RB1LB_1LA1RZ`) or of the binary seed database\n"
+        "                  and prints one line per machine: index, result, steps, tape size.\n"
+        "  --range         Only runs the machines of --machines from the first index up to\n"
+        "                  (but not including) the second one: `<from>,<to>`.\n"
+        "  --threads       Sets the amount of threads for --batch, --inputs, --enumerate\n"
+        "                  and --machines.\n"
+        "                  \033[2m(default: one per core)\033[0m\n"
+        "  --checkpoint    Writes the configuration into the given file every\n"
+        "                  --checkpoint-every steps and when --max-iter is reached, so that\n"
+        "                  the run can be continued with --resume (implies --quiet).\n"
+        "  --checkpoint-every Sets the steps between two checkpoints.\n"
+        "                  \033[2m(default: 1000000000)\033[0m\n"
+        "  --resume        Continues the machine from the given checkpoint, including its\n"
+        "                  steps, which count towards --max-iter (implies --quiet).\n"
+        "  --benchmark     Runs the machine with every interpreter and prints how long they took.\n"
+        "  --macro         Runs the machine as a macro machine that simulates blocks of the\n"
+        "                  given amount of cells at once (implies --quiet).\n"
+        "  --emit-c        Writes the machine as a C program into the given file\n"
+        "                  (`-` for stdout) instead of running it.\n"
+        "  --compile       Writes the machine in the compiled format into the given file\n"
+        "                  instead of running it. Compiled files can be run like sources.\n"
+        "  --cache         Reuses `<filename>c` if it was compiled from the same source\n"
+        "                  and creates it otherwise.\n"
+        "  --tape          Reads the initial tape from the given file which contains the\n"
+        "                  names of the symbols, separated by whitespace or commas.\n"
+        "  --raw-tape      Reads the initial tape from the given file where every byte\n"
+        "                  is the index of a symbol.\n"
+        "  --export        Writes the used part of the final tape into the given file\n"
+        "                  (`-` for stdout instead of the result) (implies --quiet).\n"
+        "  --export-format Sets the format of --export: `names` (like --tape), `rle`\n"
+        "                  (a line `<length> <name>` per run) or `raw` (like --raw-tape).\n"
+        "                  \033[2m(default: names)\033[0m\n"
         "  --view-width    Sets the amount of cells that are being printed.\n"
         "                  \033[2m(default: 9)\033[0m\n"
         "  --max-iter      Sets the maximum amount of iterations the Turing Machine can do.\n"
@@ -101,6 +201,11 @@ void print_help(void) {
     );
 }
 
+/* Checks a long flag and applies it to the arguments.
+ *
+ * @return The amount of elements of argv that were consumed
+ *         by the flag or 0 if the flag is invalid.
+ */
 int check_long(struct Arguments* arguments, const int argc, const char** const argv) {
     if(argc == 0) {
         // error
@@ -112,13 +217,133 @@ int check_long(struct Arguments* arguments, const int argc, const char** const a
         exit(EXIT_SUCCESS);
     }
 
+    if(strcmp(&argv[0][2], "quiet") == 0) {
+        arguments->quiet = true;
+        return 1;
+    }
+
+    if(strcmp(&argv[0][2], "jit") == 0) {
+        arguments->quiet = true;
+        arguments->jit = true;
+        return 1;
+    }
+
+    if(strcmp(&argv[0][2], "threaded") == 0) {
+        arguments->quiet = true;
+        arguments->threaded = true;
+        return 1;
+    }
+
+    if(strcmp(&argv[0][2], "benchmark") == 0) {
+        arguments->benchmark = true;
+        return 1;
+    }
+
+    if(strcmp(&argv[0][2], "cycles") == 0) {
+        arguments->quiet = true;
+        arguments->cycles = true;
+        return 1;
+    }
+
+    if(strcmp(&argv[0][2], "decide") == 0) {
+        arguments->decide = true;
+        return 1;
+    }
+
+    if(strcmp(&argv[0][2], "batch") == 0) {
+        arguments->batch = true;
+        return 1;
+    }
+
+    if(strcmp(&argv[0][2], "enumerate") == 0) {
+        arguments->enumerate = true;
+        return 1;
+    }
+
+    if(strcmp(&argv[0][2], "machines") == 0) {
+        arguments->machines = true;
+        return 1;
+    }
+
+    if(strcmp(&argv[0][2], "cache") == 0) {
+        arguments->cache = true;
+        return 1;
+    }
+
+    if(strcmp(&argv[0][2], "rle") == 0) {
+        arguments->quiet = true;
+        arguments->rle = true;
+        return 1;
+    }
+
     if(argc < 2) {
         fprintf(stderr, "\033[31mIf a flag is being used that contains data, the data should be provided.\033[0m\n");
         return 0;
     }
 
-    int second;
-    if(str2int(&second, argv[1], 10) != STR2INT_SUCCESS) {
+    if(strcmp(&argv[0][2], "emit-c") == 0) {
+        arguments->emit_c = argv[1];
+        return 2;
+    }
+
+    if(strcmp(&argv[0][2], "compile") == 0) {
+        arguments->compile = argv[1];
+        return 2;
+    }
+
+    if(strcmp(&argv[0][2], "tape") == 0) {
+        arguments->tape = argv[1];
+        return 2;
+    }
+
+    if(strcmp(&argv[0][2], "inputs") == 0) {
+        arguments->inputs = argv[1];
+        return 2;
+    }
+
+    if(strcmp(&argv[0][2], "undecided") == 0) {
+        arguments->undecided = argv[1];
+        return 2;
+    }
+
+    if(strcmp(&argv[0][2], "checkpoint") == 0) {
+        arguments->quiet = true;
+        arguments->checkpoint = argv[1];
+        return 2;
+    }
+
+    if(strcmp(&argv[0][2], "resume") == 0) {
+        arguments->quiet = true;
+        arguments->resume = argv[1];
+        return 2;
+    }
+
+    if(strcmp(&argv[0][2], "range") == 0) {
+        arguments->range = argv[1];
+        return 2;
+    }
+
+    if(strcmp(&argv[0][2], "raw-tape") == 0) {
+        arguments->raw_tape = argv[1];
+        return 2;
+    }
+
+    if(strcmp(&argv[0][2], "export") == 0) {
+        arguments->quiet = true;
+        arguments->export = argv[1];
+        return 2;
+    }
+
+    if(strcmp(&argv[0][2], "export-format") == 0) {
+        if(!parse_export_format(&arguments->export_format, argv[1])) {
+            fprintf(stderr, "\033[31mUnknown export format: \033[32m'%s'\033[31m.\033[0m\n", argv[1]);
+            return 0;
+        }
+        return 2;
+    }
+
+    long second;
+    if(str2long(&second, argv[1], 10) != STR2INT_SUCCESS) {
         fprintf(stderr, "\033[31mThe content of the flag has to be a number.\033[0m\n");
         return 0;
     }
@@ -130,7 +355,7 @@ int check_long(struct Arguments* arguments, const int argc, const char** const a
         }
         arguments->view_width = second;
 
-        return 1;
+        return 2;
     }
 
     if(strcmp(&argv[0][2], "max-iter") == 0) {
@@ -140,7 +365,38 @@ int check_long(struct Arguments* arguments, const int argc, const char** const a
         }
 
         arguments->max_iter = second;
-        return 1;
+        return 2;
+    }
+
+    if(strcmp(&argv[0][2], "threads") == 0) {
+        if(second < 1) {
+            fprintf(stderr, "\033[31mThere has to be at least 1 thread.\033[0m\n");
+            return 0;
+        }
+
+        arguments->threads = second;
+        return 2;
+    }
+
+    if(strcmp(&argv[0][2], "checkpoint-every") == 0) {
+        if(second < 1) {
+            fprintf(stderr, "\033[31mThere has to be at least 1 step between checkpoints.\033[0m\n");
+            return 0;
+        }
+
+        arguments->checkpoint_every = second;
+        return 2;
+    }
+
+    if(strcmp(&argv[0][2], "macro") == 0) {
+        if(second < 1) {
+            fprintf(stderr, "\033[31mThe blocks have to contain at least 1 cell.\033[0m\n");
+            return 0;
+        }
+
+        arguments->quiet = true;
+        arguments->block_size = second;
+        return 2;
     }
 
     fprintf(stderr, "\033[31mUnknown flag: \033[32m'%s'\033[31m.\033[0m\n", argv[0]);
@@ -148,17 +404,16 @@ int check_long(struct Arguments* arguments, const int argc, const char** const a
 }
 
 int parse_arguments(struct Arguments* arguments, const int argc, const char** const argv) {
-    // This function currently only supports value flags
-    // and not boolean flags. This could be added later on.
     for(int i = 2; i < argc; ++i) {
         if(argv[i][0] == '-') {
             // Check if long
             if(argv[i][1] == '-') {
-                if(!check_long(arguments, argc - i, &argv[i])) {
+                const int used = check_long(arguments, argc - i, &argv[i]);
+                if(!used) {
                     // Error handling
                     return 0;
                 }
-                ++i;
+                i += used - 1;
                 continue;
             }
 
@@ -172,6 +427,527 @@ int parse_arguments(struct Arguments* arguments, const int argc, const char** co
     return 1;
 }
 
+/* The steps that can be run until the next checkpoint is due or `max_iter` is reached.
+ */
+static size_t next_slice(const struct Arguments* const arguments, const size_t count) {
+    const size_t left = arguments->max_iter > count ? arguments->max_iter - count : 0;
+
+    if(arguments->checkpoint == NULL) {
+        return left;
+    }
+
+    // The checkpoints are written at multiples of the interval, also after resuming.
+    const size_t due = arguments->checkpoint_every - count % arguments->checkpoint_every;
+    return due < left ? due : left;
+}
+
+/* Updates the checkpoint after a slice of steps.
+ *
+ * @return true if it has to be written, as the machine is still running.
+ */
+static bool checkpoint_due(const struct Arguments* const arguments, struct Checkpoint* const checkpoint, const StateId state, const StateId halt, const size_t count) {
+    if(arguments->checkpoint == NULL || state == halt) {
+        return false;
+    }
+
+    checkpoint->state = state;
+    checkpoint->steps = count;
+    return true;
+}
+
+// The run goes on without the checkpoint, as it is more valuable than the checkpoint.
+static void checkpoint_failed(const struct Arguments* const arguments) {
+    fprintf(stderr, "\033[31mCould not write the checkpoint `%s`.\033[0m\n", arguments->checkpoint);
+}
+
+/* Runs the table on the narrowest tape that can hold the symbols of the machine.
+ * With `--checkpoint` it is run in slices with a checkpoint after each of them.
+ *
+ * @return The amount of steps that were executed (including the ones before the checkpoint).
+ */
+static size_t run_narrow(struct TuringMachine* const machine, const struct TransitionTable* const table, StateId* const state, const struct Arguments* const arguments, struct Checkpoint* const checkpoint, struct Exporter* const exporter) {
+    struct BitTape bits;
+    struct ByteTape bytes;
+    struct Tape window;
+    size_t count = arguments->steps;
+
+    if(init_bit_tape(&bits, &machine->tape)) {
+        do {
+            count += run_table_bits(table, &bits, state, next_slice(arguments, count));
+
+            if(checkpoint_due(arguments, checkpoint, *state, table->halt, count) && !write_checkpoint_bits(arguments->checkpoint, checkpoint, &machine->tape, &bits)) {
+                checkpoint_failed(arguments);
+            }
+        } while(*state != table->halt && count < arguments->max_iter);
+
+        if(exporter != NULL) {
+            export_bit_tape(exporter, &bits);
+        }
+        window = bit_tape_window(&bits, arguments->view_width);
+        free_bit_tape(&bits);
+    } else if(init_byte_tape(&bytes, &machine->tape)) {
+        do {
+            count += run_table_bytes(table, &bytes, state, next_slice(arguments, count));
+
+            if(checkpoint_due(arguments, checkpoint, *state, table->halt, count) && !write_checkpoint_bytes(arguments->checkpoint, checkpoint, &machine->tape, &bytes)) {
+                checkpoint_failed(arguments);
+            }
+        } while(*state != table->halt && count < arguments->max_iter);
+
+        if(exporter != NULL) {
+            export_byte_tape(exporter, &bytes);
+        }
+        window = byte_tape_window(&bytes, arguments->view_width);
+        free_byte_tape(&bytes);
+    } else {
+        do {
+            count += run_table(table, &machine->tape, state, next_slice(arguments, count));
+
+            if(checkpoint_due(arguments, checkpoint, *state, table->halt, count) && !write_checkpoint_cells(arguments->checkpoint, checkpoint, &machine->tape)) {
+                checkpoint_failed(arguments);
+            }
+        } while(*state != table->halt && count < arguments->max_iter);
+
+        if(exporter != NULL) {
+            export_cells(exporter, machine->tape.content, machine->tape.size);
+        }
+        return count;
+    }
+
+    // Only the visible part of the tape is converted back.
+    window.symbol_names = machine->tape.symbol_names;
+    window.symbol_len = machine->tape.symbol_len;
+
+    free_tape(&machine->tape);
+    machine->tape = window;
+
+    return count;
+}
+
+/* Opens the file of `--export` for the tape of the machine.
+ *
+ * @return The exporter or NULL if the tape is not exported.
+ */
+static struct Exporter* open_export(const struct TuringMachine* const machine, const struct Arguments* const arguments) {
+    if(arguments->export == NULL) {
+        return NULL;
+    }
+
+    FILE* out = strcmp(arguments->export, "-") == 0 ? stdout : fopen(arguments->export, "wb");
+    if(out == NULL) {
+        fprintf(stderr, "\033[31mCould not open `%s`.\033[0m\n", arguments->export);
+        exit(1);
+    }
+
+    struct Exporter* exporter = malloc(sizeof(struct Exporter));
+    if(exporter == NULL) {
+        out_of_memory();
+    }
+
+    if(!init_exporter(exporter, out, arguments->export_format, &machine->tape)) {
+        fprintf(stderr, "\033[31mThe machine has too many symbols for this export format.\033[0m\n");
+        exit(10);
+    }
+
+    return exporter;
+}
+
+/* Writes the rest of the export and closes the file.
+ *
+ * @return 1 if the whole tape was written and 0 otherwise.
+ */
+static int close_export(struct Exporter* const exporter, const struct Arguments* const arguments) {
+    int written = finish_export(exporter);
+
+    if(exporter->out != stdout && fclose(exporter->out) != 0) {
+        written = 0;
+    }
+    free(exporter);
+
+    if(!written) {
+        fprintf(stderr, "\033[31mCould not write `%s`.\033[0m\n", arguments->export);
+    }
+
+    return written;
+}
+
+/* Runs the machine without printing anything in between
+ * the steps and only reports the final configuration.
+ */
+int run_quiet(struct TuringMachine* const machine, const struct Arguments* const arguments, const uint64_t source_hash) {
+    size_t count = arguments->steps;
+    struct Cycle cycle = {0};
+
+    // After resuming, the steps of the checkpoint count towards the budget.
+    const size_t budget = arguments->max_iter > count ? arguments->max_iter - count : 0;
+
+    if(arguments->checkpoint != NULL && (arguments->cycles || arguments->block_size > 0 || arguments->rle || arguments->threaded || arguments->jit)) {
+        fprintf(stderr, "\033[31m--checkpoint only works with the default interpreter.\033[0m\n");
+        return 10;
+    }
+
+    struct Checkpoint checkpoint = {
+        .source_hash = source_hash
+    };
+
+    // The whole tape is exported before it is reduced to the visible window.
+    struct Exporter* const exporter = open_export(machine, arguments);
+
+    struct TransitionTable table;
+    if(compile_table(&table, machine)) {
+        StateId state = table.start;
+
+        struct MacroMachine macro;
+        struct JitProgram program;
+        struct ThreadedProgram threaded;
+
+        if(arguments->cycles) {
+            count += run_table_cycles(&table, &machine->tape, &state, budget, &cycle);
+            cycle.start += arguments->steps;
+            if(exporter != NULL) {
+                export_cells(exporter, machine->tape.content, machine->tape.size);
+            }
+        } else if(arguments->block_size > 0 && init_macro_machine(&macro, &table, &machine->tape, arguments->block_size)) {
+            count += run_macro(&macro, &state, budget);
+            if(exporter != NULL) {
+                export_macro_tape(exporter, &macro);
+            }
+
+            // Only the visible part of the tape is converted back.
+            struct Tape window = macro_tape_window(&macro, arguments->view_width);
+            window.symbol_names = machine->tape.symbol_names;
+            window.symbol_len = machine->tape.symbol_len;
+
+            free_tape(&machine->tape);
+            free_macro_machine(&macro);
+            machine->tape = window;
+        } else if(arguments->block_size > 0) {
+            fprintf(stderr, "\033[31mA block cannot contain %zu cells of this machine.\033[0m\n", arguments->block_size);
+            free_table(&table);
+            if(exporter != NULL) {
+                close_export(exporter, arguments);
+            }
+            return 10;
+        } else if(arguments->rle) {
+            struct RunTape runs = init_run_tape(&machine->tape);
+            count += run_table_runs(&table, &runs, &state, budget);
+            if(exporter != NULL) {
+                export_run_tape(exporter, &runs);
+            }
+
+            // Only the visible part of the tape is converted back.
+            struct Tape window = run_tape_window(&runs, arguments->view_width);
+            window.symbol_names = machine->tape.symbol_names;
+            window.symbol_len = machine->tape.symbol_len;
+
+            free_tape(&machine->tape);
+            free_run_tape(&runs);
+            machine->tape = window;
+        } else if(arguments->threaded) {
+            compile_threaded(&threaded, &table);
+            count += run_threaded(&threaded, &machine->tape, &state, budget);
+            free_threaded(&threaded);
+            if(exporter != NULL) {
+                export_cells(exporter, machine->tape.content, machine->tape.size);
+            }
+        } else if(arguments->jit && compile_jit(&program, &table)) {
+            count += run_jit(&program, &machine->tape, &state, budget);
+            free_jit(&program);
+            if(exporter != NULL) {
+                export_cells(exporter, machine->tape.content, machine->tape.size);
+            }
+        } else {
+            if(arguments->jit) {
+                fprintf(stderr, "The JIT is not supported on this platform. Using the interpreter.\n");
+            }
+
+            count = run_narrow(machine, &table, &state, arguments, &checkpoint, exporter);
+        }
+
+        machine->state = table_state(machine, &table, state);
+
+        free_table(&table);
+    } else {
+        // The machine is too large for the table, so the
+        // states are being interpreted directly.
+        while(machine->state != NULL && count < arguments->max_iter) {
+            next_state(machine);
+            ++count;
+
+            if(arguments->checkpoint != NULL && machine->state != NULL && (count % arguments->checkpoint_every == 0 || count == arguments->max_iter)) {
+                checkpoint.state = machine->state - machine->states;
+                checkpoint.steps = count;
+
+                if(!write_checkpoint_cells(arguments->checkpoint, &checkpoint, &machine->tape)) {
+                    checkpoint_failed(arguments);
+                }
+            }
+        }
+
+        if(exporter != NULL) {
+            export_cells(exporter, machine->tape.content, machine->tape.size);
+        }
+    }
+
+    // The result would be mixed with the tape if it is exported to stdout.
+    if(exporter == NULL || exporter->out != stdout) {
+        printf("\033[1;4mResult:\033[0m\n\n");
+        printf("State: %s\n", machine->state == NULL ? "HALT" : machine->state->name);
+        print_machine(machine, arguments->view_width);
+        printf("Steps: %zu\n", count);
+
+        if(cycle.period > 0 && cycle.shift == 0) {
+            printf("Provably loops: period %zu starting at step %zu.\n", cycle.period, cycle.start);
+        } else if(cycle.period > 0) {
+            printf("Provably loops: period %zu starting at step %zu, shifted by %ld cells each period.\n", cycle.period, cycle.start, cycle.shift);
+        }
+    }
+
+    if(exporter != NULL && !close_export(exporter, arguments)) {
+        return 1;
+    }
+
+    if(cycle.period > 0) {
+        return 3;
+    }
+
+    if(machine->state != NULL) {
+        fprintf(stderr, "\033[31mError: Maximum iterations reached: %zu. Stopping.\033[0m\n", arguments->max_iter);
+        return 2;
+    }
+
+    return 0;
+}
+
+static void print_benchmark(const char* const name, const size_t steps, const clock_t start) {
+    const double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    printf("%-12s %14zu steps %10.3f s", name, steps, seconds);
+    if(seconds > 0) {
+        printf(" %12.2f Msteps/s", steps / seconds / 1e6);
+    }
+    printf("\n");
+}
+
+/* Runs the machine with every interpreter on a copy
+ * of the tape and prints how long each of them took.
+ */
+int run_benchmark(const struct TuringMachine* const machine, const struct Arguments* const arguments) {
+    printf("\033[1;4mBenchmark:\033[0m\n\n");
+
+    // The loop of the normal execution without the printing.
+    struct TuringMachine copy = *machine;
+    copy.tape = copy_tape(&machine->tape);
+
+    clock_t start = clock();
+    size_t count = 0;
+    while(copy.state != NULL && count < arguments->max_iter) {
+        next_state(&copy);
+        ++count;
+    }
+    print_benchmark("states", count, start);
+    free_tape(&copy.tape);
+
+    struct TransitionTable table;
+    if(!compile_table(&table, machine)) {
+        fprintf(stderr, "\033[31mThe machine has too many states for the transition table.\033[0m\n");
+        return 10;
+    }
+
+    struct Tape tape = copy_tape(&machine->tape);
+    StateId state = table.start;
+    start = clock();
+    print_benchmark("table", run_table(&table, &tape, &state, arguments->max_iter), start);
+    free_tape(&tape);
+
+    struct ByteTape bytes;
+    state = table.start;
+    if(init_byte_tape(&bytes, &machine->tape)) {
+        start = clock();
+        print_benchmark("table 8-bit", run_table_bytes(&table, &bytes, &state, arguments->max_iter), start);
+        free_byte_tape(&bytes);
+    }
+
+    struct BitTape bits;
+    state = table.start;
+    if(init_bit_tape(&bits, &machine->tape)) {
+        start = clock();
+        print_benchmark("table 1-bit", run_table_bits(&table, &bits, &state, arguments->max_iter), start);
+        free_bit_tape(&bits);
+    }
+
+    struct ThreadedProgram threaded;
+    tape = copy_tape(&machine->tape);
+    state = table.start;
+    start = clock();
+    compile_threaded(&threaded, &table);
+    print_benchmark("threaded", run_threaded(&threaded, &tape, &state, arguments->max_iter), start);
+    free_threaded(&threaded);
+    free_tape(&tape);
+
+    struct JitProgram program;
+    tape = copy_tape(&machine->tape);
+    state = table.start;
+    start = clock();
+    if(compile_jit(&program, &table)) {
+        print_benchmark("jit", run_jit(&program, &tape, &state, arguments->max_iter), start);
+        free_jit(&program);
+    }
+    free_tape(&tape);
+
+    free_table(&table);
+
+    return 0;
+}
+
+// The parser reports all errors itself, so only the exit code is left.
+static struct TuringMachine* parse_or_exit(const char* const file_name) {
+    int status;
+    struct TuringMachine* const machine = parse(file_name, &status);
+
+    if(machine == NULL) {
+        exit(status);
+    }
+
+    return machine;
+}
+
+/* Loads the machine from a source or a compiled file. With `--cache`
+ * the compiled file next to the source is used if it is up to date.
+ */
+static struct TuringMachine* load(const char* const file_name, const struct Arguments* const arguments, uint64_t* const source_hash) {
+    struct MappedFile file;
+    if(!map_file(&file, file_name)) {
+        fprintf(stderr, "File path `%s` does not exist.\n", file_name);
+        exit(1);
+    }
+
+    if(is_compiled(&file)) {
+        struct TuringMachine* machine = load_compiled(&file);
+        *source_hash = compiled_source_hash(&file);
+        unmap_file(&file);
+
+        if(machine == NULL) {
+            fprintf(stderr, "\033[31m`%s` is not a valid compiled machine.\033[0m\n", file_name);
+            exit(1);
+        }
+
+        return machine;
+    }
+
+    *source_hash = hash_source(&file);
+    unmap_file(&file);
+
+    if(!arguments->cache) {
+        return parse_or_exit(file_name);
+    }
+
+    char* cache_name = malloc(strlen(file_name) + sizeof(COMPILED_EXTENSION));
+    if(cache_name == NULL) {
+        out_of_memory();
+    }
+    strcpy(cache_name, file_name);
+    strcat(cache_name, COMPILED_EXTENSION);
+
+    struct MappedFile cache;
+    if(map_file(&cache, cache_name)) {
+        struct TuringMachine* machine = NULL;
+        if(is_compiled(&cache) && compiled_source_hash(&cache) == *source_hash) {
+            machine = load_compiled(&cache);
+        }
+        unmap_file(&cache);
+
+        if(machine != NULL) {
+            free(cache_name);
+            return machine;
+        }
+    }
+
+    struct TuringMachine* machine = parse_or_exit(file_name);
+
+    // The cache is only an optimization, so the machine is still run if it cannot be written.
+    FILE* out = fopen(cache_name, "wb");
+    if(out == NULL || !write_compiled(out, machine, *source_hash)) {
+        fprintf(stderr, "Could not write the cache `%s`.\n", cache_name);
+    }
+    if(out != NULL) {
+        fclose(out);
+    }
+
+    free(cache_name);
+
+    return machine;
+}
+
+/* Does what the arguments ask for with the parsed machine.
+ *
+ * @return The exit code of the program.
+ */
+static int run(struct TuringMachine* const machine, const struct Arguments* const arguments, const char* const source, const uint64_t source_hash) {
+    if(arguments->compile != NULL) {
+        FILE* out = fopen(arguments->compile, "wb");
+        if(out == NULL || !write_compiled(out, machine, source_hash)) {
+            fprintf(stderr, "\033[31mCould not write `%s`.\033[0m\n", arguments->compile);
+            return 1;
+        }
+
+        fclose(out);
+        return 0;
+    }
+
+    if(arguments->emit_c != NULL) {
+        FILE* out = strcmp(arguments->emit_c, "-") == 0 ? stdout : fopen(arguments->emit_c, "w");
+        if(out == NULL) {
+            fprintf(stderr, "\033[31mCould not open `%s`.\033[0m\n", arguments->emit_c);
+            return 1;
+        }
+
+        emit_c(out, machine, source, arguments->max_iter, arguments->view_width);
+
+        if(out != stdout) {
+            fclose(out);
+        }
+        return 0;
+    }
+
+    if(arguments->decide) {
+        const enum Verdict verdict = decide(machine);
+
+        if(verdict != VERDICT_UNKNOWN) {
+            printf("\033[1;4mResult:\033[0m\n\n");
+            printf("Never halts: %s\n", verdict_reason(verdict));
+            return 3;
+        }
+    }
+
+    if(arguments->benchmark) {
+        return run_benchmark(machine, arguments);
+    }
+
+    if(arguments->quiet) {
+        return run_quiet(machine, arguments, source_hash);
+    }
+
+    printf("\033[1;4mExecution sequence:\033[0m\n\n");
+
+    size_t count = 0;
+    while(machine->state != NULL) {
+        printf("State: %s\n", machine->state->name);
+        print_machine(machine, arguments->view_width);
+        next_state(machine);
+        printf("\n");
+        ++count;
+        if(count >= arguments->max_iter) {
+            fprintf(stderr, "\033[31mError: Maximum iterations reached: %zu. Stopping.\033[0m\n", arguments->max_iter);
+            return 2;
+        }
+    }
+    printf("State: HALT\n");
+    print_machine(machine, arguments->view_width);
+
+    return 0;
+}
+
 int main(const int argc, const char** const argv) {
     if(argc < 2) {
         fprintf(stderr, "A file path has to be provided: `tau <path>`\n");
@@ -180,7 +956,9 @@ int main(const int argc, const char** const argv) {
 
     struct Arguments arguments = {
         .view_width = 9,
-        .max_iter = 5000
+        .max_iter = 5000,
+        .checkpoint_every = CHECKPOINT_EVERY,
+        .export_format = EXPORT_NAMES
     };
 
     if(strcmp(argv[1], "--help") == 0) {
@@ -193,22 +971,55 @@ int main(const int argc, const char** const argv) {
         return 10;
     }
     
-    struct TuringMachine* machine = parse(argv[1]);
+    const struct BatchOptions options = {
+        .max_iter = arguments.max_iter,
+        .threads = arguments.threads,
+        .cycles = arguments.cycles,
+        .decide = arguments.decide
+    };
 
-    printf("\033[1;4mExecution sequence:\033[0m\n\n");
+    if(arguments.batch) {
+        return run_batch(argv[1], &options, stdout);
+    }
 
-    size_t count = 0;
-    while(machine->state != NULL) {
-        printf("State: %s\n", machine->state->name);
-        print_machine(machine, arguments.view_width);
-        next_state(machine);
-        printf("\n");
-        ++count;
-        if(count >= arguments.max_iter) {
-            fprintf(stderr, "\033[31mError: Maximum iterations reached: %zu. Stopping.\033[0m\n", arguments.max_iter);
-            return 2;
-        }
+    if(arguments.enumerate) {
+        return run_enumerate(argv[1], &options, arguments.undecided, stdout);
     }
-    printf("State: HALT\n");
-    print_machine(machine, arguments.view_width);
+
+    if(arguments.machines) {
+        return run_machines(argv[1], arguments.range, &options, stdout);
+    }
+
+    uint64_t source_hash;
+    struct TuringMachine* machine = load(argv[1], &arguments, &source_hash);
+
+    // A tape from a file replaces the one from the head.
+    if(arguments.tape != NULL && !load_tape_names(&machine->tape, arguments.tape)) {
+        fprintf(stderr, "File path `%s` does not exist.\n", arguments.tape);
+        return 1;
+    }
+    if(arguments.raw_tape != NULL && !load_tape_raw(&machine->tape, arguments.raw_tape)) {
+        fprintf(stderr, "File path `%s` does not exist.\n", arguments.raw_tape);
+        return 1;
+    }
+
+    // The checkpoint replaces the tape and the state that the machine starts with.
+    if(arguments.resume != NULL && !load_checkpoint(machine, arguments.resume, source_hash, &arguments.steps)) {
+        fprintf(stderr, "File path `%s` does not exist.\n", arguments.resume);
+        return 1;
+    }
+
+    // The machine is only parsed once for all of the inputs.
+    if(arguments.inputs != NULL) {
+        const int result = run_inputs(machine, arguments.inputs, &options, stdout);
+
+        free_machine(machine);
+        return result;
+    }
+
+    const int result = run(machine, &arguments, argv[1], source_hash);
+
+    free_machine(machine);
+
+    return result;
 }
@@ -0,0 +1,161 @@
+#include "memory.h"
+
+#include <stdio.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define MEMORY_RESERVE
+#endif
+
+// The address space that is being reserved at most.
+#define RESERVE_BYTES (sizeof(void*) >= 8 ? (size_t)1 << 38 : (size_t)1 << 28)
+
+void out_of_memory(void) {
+    fprintf(stderr, "Not enough memory\n");
+    exit(EXIT_FAILURE);
+}
+
+void* reserve_memory(size_t* const bytes, const size_t minimum) {
+#ifdef MEMORY_RESERVE
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_NORESERVE
+    flags |= MAP_NORESERVE;
+#endif
+
+    for(size_t size = RESERVE_BYTES; size >= minimum && size >= MEMORY_CHUNK; size /= 2) {
+        void* const range = mmap(NULL, size, PROT_NONE, flags, -1, 0);
+
+        if(range == MAP_FAILED) {
+            continue;
+        }
+
+        *bytes = size;
+        return range;
+    }
+#endif
+    (void)bytes;
+    (void)minimum;
+
+    return NULL;
+}
+
+int commit_memory(void* const start, const size_t bytes) {
+#ifdef MEMORY_RESERVE
+    return mprotect(start, bytes, PROT_READ | PROT_WRITE) == 0;
+#else
+    (void)start;
+    (void)bytes;
+
+    return 0;
+#endif
+}
+
+void release_memory(void* const start, const size_t bytes) {
+#ifdef MEMORY_RESERVE
+    munmap(start, bytes);
+#else
+    (void)start;
+    (void)bytes;
+#endif
+}
+
+// Reads everything that is left in the file into the heap.
+static char* read_file(FILE* const fptr, size_t* const size) {
+    size_t allocated = MEMORY_CHUNK;
+    char* content = malloc(allocated);
+    *size = 0;
+
+    while(content != NULL) {
+        *size += fread(content + *size, 1, allocated - *size, fptr);
+
+        if(*size < allocated) {
+            break;
+        }
+
+        allocated *= 2;
+        char* const grown = realloc(content, allocated);
+        if(grown == NULL) {
+            free(content);
+        }
+        content = grown;
+    }
+
+    if(content == NULL) {
+        out_of_memory();
+    }
+
+    return content;
+}
+
+int map_file(struct MappedFile* const file, const char* const file_name) {
+    FILE* const fptr = fopen(file_name, "rb");
+    if(fptr == NULL) {
+        return 0;
+    }
+
+#ifdef MEMORY_RESERVE
+    struct stat status;
+
+    // Empty files and things like pipes cannot be mapped.
+    if(fstat(fileno(fptr), &status) == 0 && S_ISREG(status.st_mode) && status.st_size > 0) {
+        void* const content = mmap(NULL, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, fileno(fptr), 0);
+
+        if(content != MAP_FAILED) {
+            fclose(fptr);
+
+            *file = (struct MappedFile){
+                .content = content,
+                .size = (size_t)status.st_size,
+                .mapped = true
+            };
+
+            return 1;
+        }
+    }
+#endif
+
+    size_t size;
+    char* const content = read_file(fptr, &size);
+    fclose(fptr);
+
+    *file = (struct MappedFile){
+        .content = content,
+        .size = size,
+        .mapped = false
+    };
+
+    return 1;
+}
+
+void unmap_file(struct MappedFile* const file) {
+#ifdef MEMORY_RESERVE
+    if(file->mapped) {
+        munmap((void*)file->content, file->size);
+    }
+#endif
+    if(!file->mapped) {
+        free((void*)file->content);
+    }
+
+    file->content = NULL;
+    file->size = 0;
+}
+
+uint64_t hash_bytes(const char* const data, const size_t size) {
+    uint64_t hash = 0xCBF29CE484222325ull;
+
+    for(size_t i = 0; i < size; ++i) {
+        hash ^= (unsigned char)data[i];
+        hash *= 0x100000001B3ull;
+    }
+
+    return hash;
+}
+
+size_t hash_slot(const char* const data, const size_t size, const size_t allocated) {
+    const uint64_t hash = hash_bytes(data, size);
+
+    return (size_t)(hash ^ hash >> 32) & (allocated - 1);
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// Ends the program after an allocation failed.
+void out_of_memory(void);
+
+// Memory is always committed in whole chunks so that the borders
+// stay page aligned (64 KiB is a multiple of all common page sizes).
+#define MEMORY_CHUNK ((size_t)1 << 16)
+
+/* Reserves a range of the address space without using any memory.
+ * If the address space is limited, it tries smaller ranges, but
+ * never less than `minimum` bytes.
+ *
+ * @return The start of the range (the size is written into `bytes`)
+ *         or NULL if nothing could be reserved.
+ */
+void* reserve_memory(size_t* const bytes, const size_t minimum);
+
+/* Makes a part of a reserved range usable. The memory is zeroed.
+ *
+ * @return 1 if it was successful and 0 otherwise.
+ */
+int commit_memory(void* const start, const size_t bytes);
+
+void release_memory(void* const start, const size_t bytes);
+
+// A whole file that can be read like a string (it is not null terminated).
+struct MappedFile {
+    const char* content;
+    size_t size;
+
+    // Whether the content is mapped or was read into the heap.
+    bool mapped;
+};
+
+/* Maps the file into memory. If that is not possible,
+ * the file is read into the heap instead.
+ *
+ * @return 1 if it was successful and 0 if the file could not be opened.
+ */
+int map_file(struct MappedFile* const file, const char* const file_name);
+
+void unmap_file(struct MappedFile* const file);
+
+// FNV-1a over the bytes, which is used for the names in hash tables and the hash of a source.
+uint64_t hash_bytes(const char* const data, const size_t size);
+
+/* The first slot of the bytes in an open addressed hash table,
+ * which needs a power of two as the amount of slots.
+ */
+size_t hash_slot(const char* const data, const size_t size, const size_t allocated);
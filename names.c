@@ -0,0 +1,46 @@
+#include "names.h"
+
+#include "memory.h"
+
+static struct Name* find_slot(const struct NameTable* const table, const struct Lexer* const lexer, const struct Token* const name) {
+    size_t i = hash_slot(lexer->source.content + name->position, name->length, table->allocated);
+
+    while(table->names[i].token.length != 0 && !same_token(lexer, &table->names[i].token, name)) {
+        i = (i + 1) & (table->allocated - 1);
+    }
+
+    return &table->names[i];
+}
+
+void init_name_table(struct NameTable* const table, struct Arena* const arena, const size_t amount) {
+    // At most half of the slots are used so that the probing stays short.
+    size_t allocated = 16;
+    while(allocated < amount * 2) {
+        allocated *= 2;
+    }
+
+    *table = (struct NameTable){
+        .names = arena_alloc(arena, sizeof(struct Name) * allocated),
+        .allocated = allocated
+    };
+}
+
+int add_name(struct NameTable* const table, const struct Lexer* const lexer, const struct Token* const name, const size_t index) {
+    struct Name* const slot = find_slot(table, lexer, name);
+    if(slot->token.length != 0) {
+        return 0;
+    }
+
+    *slot = (struct Name){
+        .token = *name,
+        .index = index
+    };
+
+    return 1;
+}
+
+size_t find_name(const struct NameTable* const table, const struct Lexer* const lexer, const struct Token* const name) {
+    const struct Name* const slot = find_slot(table, lexer, name);
+
+    return slot->token.length == 0 ? (size_t)-1 : slot->index;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stdbool.h>
+
+#include "lexer.h"
+
+struct Name {
+    // The slot is empty if the token has no length.
+    struct Token token;
+    size_t index;
+};
+
+/* A hash table from the names in the source to their index
+ * (e.g. the index of a symbol or a state), so that names
+ * can be resolved without comparing them to every other name.
+ *
+ * The size is fixed when it is created, which is why it
+ * has to know how many names will be added at most.
+ * It lives as long as the arena it was created in.
+ */
+struct NameTable {
+    struct Name* names;
+    size_t allocated;
+};
+
+void init_name_table(struct NameTable* const table, struct Arena* const arena, const size_t amount);
+
+/* Adds the name with the index, if it does not exist yet.
+ *
+ * @return 1 if it was added and 0 if the name already existed.
+ */
+int add_name(struct NameTable* const table, const struct Lexer* const lexer, const struct Token* const name, const size_t index);
+
+/* Finds the index of the name.
+ *
+ * @return The index or `(size_t)-1` if the name does not exist.
+ */
+size_t find_name(const struct NameTable* const table, const struct Lexer* const lexer, const struct Token* const name);
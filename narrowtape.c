@@ -0,0 +1,199 @@
+#include "narrowtape.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "memory.h"
+
+// The tapes double their size, as long as there is enough reserved space.
+#define GROW_AMOUNT(size, available) ((size) < (available) ? (size) : (available))
+
+static size_t round_chunk(const size_t bytes) {
+    return (bytes + MEMORY_CHUNK - 1) / MEMORY_CHUNK * MEMORY_CHUNK;
+}
+
+/* Reserves the address space with the first `bytes` committed at the origin
+ * and filled with `fill`.
+ *
+ * @return The origin or NULL if it was not possible.
+ */
+static void* reserve_origin(void** const reserved, size_t* const reserved_size, const size_t bytes, const int fill) {
+    *reserved = reserve_memory(reserved_size, bytes * 2);
+    if(*reserved == NULL) {
+        return NULL;
+    }
+
+    unsigned char* const origin = (unsigned char*)*reserved + *reserved_size / 2;
+    if(!commit_memory(origin, bytes)) {
+        release_memory(*reserved, *reserved_size);
+        return NULL;
+    }
+
+    if(fill != 0) {
+        memset(origin, fill, bytes);
+    }
+
+    return origin;
+}
+
+// Commits the bytes in front of or behind the used part of the range.
+static void grow(void* const start, const size_t bytes, const int fill) {
+    if(bytes == 0 || !commit_memory(start, bytes)) {
+        out_of_memory();
+    }
+
+    if(fill != 0) {
+        memset(start, fill, bytes);
+    }
+}
+
+int init_byte_tape(struct ByteTape* const narrow, const struct Tape* const tape) {
+    if(tape->symbol_len > 256) {
+        return 0;
+    }
+
+    const size_t committed = round_chunk(tape->size);
+
+    void* reserved;
+    size_t reserved_size;
+    uint8_t* const content = reserve_origin(&reserved, &reserved_size, committed, tape->def);
+    if(content == NULL) {
+        return 0;
+    }
+
+    for(size_t i = 0; i < tape->size; ++i) {
+        content[i] = (uint8_t)tape->content[i];
+    }
+
+    *narrow = (struct ByteTape){
+        .content = content,
+        .size = committed,
+        .def = (uint8_t)tape->def,
+        .cursor = tape->cursor,
+        .reserved = reserved,
+        .reserved_size = reserved_size
+    };
+
+    return 1;
+}
+
+int init_bit_tape(struct BitTape* const narrow, const struct Tape* const tape) {
+    if(tape->symbol_len > 2) {
+        return 0;
+    }
+
+    const size_t committed = round_chunk((tape->size + 7) / 8);
+
+    void* reserved;
+    size_t reserved_size;
+    uint64_t* const words = reserve_origin(&reserved, &reserved_size, committed, tape->def ? 0xFF : 0);
+    if(words == NULL) {
+        return 0;
+    }
+
+    *narrow = (struct BitTape){
+        .words = words,
+        .size = committed / sizeof(uint64_t),
+        .def = tape->def,
+        .cursor = tape->cursor,
+        .reserved = reserved,
+        .reserved_size = reserved_size / sizeof(uint64_t)
+    };
+
+    for(size_t i = 0; i < tape->size; ++i) {
+        BIT_SET(narrow, i, tape->content[i]);
+    }
+
+    return 1;
+}
+
+void grow_byte_left(struct ByteTape* const tape) {
+    const size_t amount = GROW_AMOUNT(tape->size, (size_t)(tape->content - tape->reserved));
+
+    grow(tape->content - amount, amount, tape->def);
+
+    tape->content -= amount;
+    tape->size += amount;
+    tape->cursor = amount - 1;
+}
+
+void grow_byte_right(struct ByteTape* const tape) {
+    const size_t amount = GROW_AMOUNT(tape->size, (size_t)((tape->reserved + tape->reserved_size) - (tape->content + tape->size)));
+
+    grow(tape->content + tape->size, amount, tape->def);
+
+    tape->size += amount;
+}
+
+void grow_bit_left(struct BitTape* const tape) {
+    const size_t amount = GROW_AMOUNT(tape->size, (size_t)(tape->words - tape->reserved));
+
+    grow(tape->words - amount, amount * sizeof(uint64_t), tape->def ? 0xFF : 0);
+
+    tape->words -= amount;
+    tape->size += amount;
+    tape->cursor = amount * 64 - 1;
+}
+
+void grow_bit_right(struct BitTape* const tape) {
+    const size_t amount = GROW_AMOUNT(tape->size, (size_t)((tape->reserved + tape->reserved_size) - (tape->words + tape->size)));
+
+    grow(tape->words + tape->size, amount * sizeof(uint64_t), tape->def ? 0xFF : 0);
+
+    tape->size += amount;
+}
+
+static struct Tape window_tape(Symbol* const content, const size_t width, const Symbol def) {
+    struct Tape window = init_tape_full(def, content, width);
+    window.cursor = width / 2;
+
+    return window;
+}
+
+struct Tape byte_tape_window(const struct ByteTape* const tape, const size_t width) {
+    Symbol* const content = malloc(sizeof(Symbol) * width);
+    if(content == NULL) {
+        out_of_memory();
+    }
+
+    for(size_t i = 0; i < width; ++i) {
+        const long cell = (long)tape->cursor - (long)(width / 2) + (long)i;
+        content[i] = cell < 0 || cell >= (long)tape->size ? tape->def : tape->content[cell];
+    }
+
+    return window_tape(content, width, tape->def);
+}
+
+struct Tape bit_tape_window(const struct BitTape* const tape, const size_t width) {
+    Symbol* const content = malloc(sizeof(Symbol) * width);
+    if(content == NULL) {
+        out_of_memory();
+    }
+
+    for(size_t i = 0; i < width; ++i) {
+        const long cell = (long)tape->cursor - (long)(width / 2) + (long)i;
+        content[i] = cell < 0 || cell >= (long)(tape->size * 64) ? tape->def : (Symbol)BIT_GET(tape, (size_t)cell);
+    }
+
+    return window_tape(content, width, tape->def);
+}
+
+void export_byte_tape(struct Exporter* const exporter, const struct ByteTape* const tape) {
+    export_bytes(exporter, tape->content, tape->size);
+}
+
+void export_bit_tape(struct Exporter* const exporter, const struct BitTape* const tape) {
+    export_bits(exporter, tape->words, 0, tape->size * 64);
+}
+
+void free_byte_tape(struct ByteTape* const tape) {
+    release_memory(tape->reserved, tape->reserved_size);
+    tape->reserved = NULL;
+    tape->content = NULL;
+}
+
+void free_bit_tape(struct BitTape* const tape) {
+    release_memory(tape->reserved, tape->reserved_size * sizeof(uint64_t));
+    tape->reserved = NULL;
+    tape->words = NULL;
+}
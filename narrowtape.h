@@ -0,0 +1,79 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "export.h"
+#include "tape.h"
+
+/* Tapes that only use as much memory per cell as the alphabet needs.
+ * Like the normal tape, they are windows into a reserved range of the
+ * address space that grow in both directions without copying.
+ */
+
+// One byte per cell for up to 256 symbols.
+struct ByteTape {
+    uint8_t* content;
+    size_t size;
+
+    uint8_t def;
+
+    size_t cursor;
+
+    uint8_t* reserved;
+    size_t reserved_size;
+};
+
+// One bit per cell for machines with two symbols.
+struct BitTape {
+    uint64_t* words;
+    // The amount of words
+    size_t size;
+
+    bool def;
+
+    // The index of the bit
+    size_t cursor;
+
+    uint64_t* reserved;
+    size_t reserved_size;
+};
+
+#define BIT_GET(tape, index) (((tape)->words[(index) >> 6] >> ((index) & 63)) & 1)
+#define BIT_SET(tape, index, bit) ((tape)->words[(index) >> 6] = \
+            ((tape)->words[(index) >> 6] & ~((uint64_t)1 << ((index) & 63))) | ((uint64_t)(bit) << ((index) & 63)))
+
+/* Copies the tape into a narrow tape.
+ *
+ * @return 1 if it was successful and 0 if the symbols do
+ *         not fit or no address space could be reserved.
+ */
+int init_byte_tape(struct ByteTape* const narrow, const struct Tape* const tape);
+
+int init_bit_tape(struct BitTape* const narrow, const struct Tape* const tape);
+
+// Only called if the head is at the first cell and moves left.
+void grow_byte_left(struct ByteTape* const tape);
+
+// Only called if the head moved past the last cell.
+void grow_byte_right(struct ByteTape* const tape);
+
+void grow_bit_left(struct BitTape* const tape);
+
+void grow_bit_right(struct BitTape* const tape);
+
+/* Converts the cells around the head into a normal tape
+ * with `width / 2` cells on the left of the head.
+ */
+struct Tape byte_tape_window(const struct ByteTape* const tape, const size_t width);
+
+struct Tape bit_tape_window(const struct BitTape* const tape, const size_t width);
+
+// Exports the cells of the whole tape from left to right.
+void export_byte_tape(struct Exporter* const exporter, const struct ByteTape* const tape);
+
+void export_bit_tape(struct Exporter* const exporter, const struct BitTape* const tape);
+
+void free_byte_tape(struct ByteTape* const tape);
+
+void free_bit_tape(struct BitTape* const tape);
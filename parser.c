@@ -4,76 +4,72 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "arena.h"
 #include "lexer.h"
+#include "names.h"
 #include "error.h"
 #include "tape.h"
 
-#define TO_END goto end
-
+/* Errors are reported where they are found, but parsing continues with the next
+ * statement or state, so that all of the errors of a file are shown at once.
+ * That is why the parsing functions return false instead of stopping the program.
+ */
 #define CHECK_TOKEN(token_name, message) if (lexer->curr_token.type != token_name) { \
-            fseek(lexer->fptr, lexer->curr_token.position, SEEK_SET); \
-            print_parser_error(lexer->fptr, lexer->file_name, "Invalid Token", message); \
-            exit(10); \
+            print_parser_error(lexer, lexer->curr_token.position, "Invalid Token", message); \
+            return false; \
         }
 
+// The names are only references into the source until the machine is created.
 struct Head {
-    char* blank;
+    // Everything that is only needed while parsing is allocated from here.
+    struct Arena* arena;
+
+    struct Token blank;
     Symbol blank_number;
     bool blank_defined;
 
-    char** symbols;
+    struct Token* symbols;
     size_t symbol_len;
+    struct NameTable symbol_table;
 
-    char** tape_elems;
+    struct Token* tape_elems;
     Symbol* tape;
     size_t tape_len;
 
-    char* start_state;
-    char* end_state;
+    struct Token start_state;
+    bool start_defined;
+
+    struct Token end_state;
+    bool end_defined;
 };
 
-static char* halt = "HALT";
+static const char* const halt = "HALT";
 
-inline static size_t find_symbol(const struct Head* const head, const char* const name) {
-    for(size_t i = 0; i < head->symbol_len; ++i) {
-        if(strcmp(head->symbols[i], name) == 0) {
-            return i;
-        }
-    }
+inline static size_t find_symbol(const struct Lexer* const lexer, const struct Head* const head, const struct Token* const name) {
+    return find_name(&head->symbol_table, lexer, name);
+}
 
-    return (size_t)-1;
+static bool is_end_state(const struct Lexer* const lexer, const struct Head* const head, const struct Token* const name) {
+    return head->end_defined ? same_token(lexer, &head->end_state, name) : token_equals(lexer, name, halt);
 }
 
-static size_t parse_symbol_list(struct Lexer* const lexer, char*** const symbols) {
+static bool parse_symbol_list(struct Lexer* const lexer, struct Arena* const arena, struct Token** const symbols, size_t* const symbols_size) {
     size_t allocated = 16;
-    *symbols = malloc(sizeof(Symbol) * allocated);
+    *symbols = arena_alloc(arena, sizeof(struct Token) * allocated);
 
     size_t size = 0;
 
     while (1) {
         next_token(lexer);
-        
-        if (lexer->curr_token.type == TOK_EOF) {
-            // TODO: Way better error
-
-            fprintf(stderr, "End of file whilst parsing list.\n");
-            exit(10);
-        }
 
         CHECK_TOKEN(TOK_IDENTIFIER, "A list can only contain identifiers.");
 
         if(allocated < size + 1) {
-            *symbols = realloc(*symbols, sizeof(Symbol) * allocated * 2);
-
-            if (*symbols == NULL) {
-                fprintf(stderr, "Error whilst reallocating array.\n");
-                exit(1);
-            }
-            
+            *symbols = arena_resize(arena, *symbols, sizeof(struct Token) * allocated, sizeof(struct Token) * allocated * 2);
             allocated *= 2;
         }
 
-        (*symbols)[size] = lexer->curr_token.content;
+        (*symbols)[size] = lexer->curr_token;
         ++size;
 
         if (lexer->next_token.type != TOK_COMMA) {
@@ -84,176 +80,204 @@ static size_t parse_symbol_list(struct Lexer* const lexer, char*** const symbols
         next_token(lexer);
     };
     
-    // Even though it should never change the pointer as this
-    // will always shrink the amount that was allocated, this
-    // uses the returned pointer in case there is some weird
-    // stuff happening (Same reason why it is also checked).
-    *symbols = realloc(*symbols, sizeof(Symbol) * size);
-    if (*symbols == NULL) {
-        fprintf(stderr, "Error whilst reallocating array.\n");
-        exit(1);
-    }
+    *symbols = arena_resize(arena, *symbols, sizeof(struct Token) * allocated, sizeof(struct Token) * size);
+    *symbols_size = size;
 
-    return size;
+    return true;
 }
 
 #define CHECK_MULTIPLE_DEFINITION(check, message) if (check) { \
-            print_parser_error(lexer->fptr, lexer->file_name, "Multiple Definition", message); \
-            exit(10); \
+            print_parser_error(lexer, lexer->curr_token.position, "Multiple Definition", message); \
+            return false; \
         }
 
-static void parse_statement(struct Lexer* const lexer, struct Head* head, const char* const name) {
+static bool parse_statement(struct Lexer* const lexer, struct Head* head, const struct Token name) {
     next_token(lexer);
 
     CHECK_TOKEN(TOK_EQUALS, "Statement has to have a `=`.");
     
-    if(strcmp(name, "blank") == 0) {
+    if(token_equals(lexer, &name, "blank")) {
         CHECK_MULTIPLE_DEFINITION(head->blank_defined, "Blank specified multiple times.");
 
         next_token(lexer);
 
         CHECK_TOKEN(TOK_IDENTIFIER, "Content of 'blank' has to be an identifier.");
         
-        head->blank = lexer->curr_token.content;
+        head->blank = lexer->curr_token;
         head->blank_defined = true;
 
-        TO_END;
+        return true;
     }
 
-    if (strcmp(name, "start") == 0) {
-        CHECK_MULTIPLE_DEFINITION(head->start_state != 0, "Start state specified multiple times.");
+    if (token_equals(lexer, &name, "start")) {
+        CHECK_MULTIPLE_DEFINITION(head->start_defined, "Start state specified multiple times.");
 
         next_token(lexer);
 
         CHECK_TOKEN(TOK_IDENTIFIER, "Content of 'start' has to be an identifier.");
 
-        head->start_state = lexer->curr_token.content;
+        head->start_state = lexer->curr_token;
+        head->start_defined = true;
 
-        TO_END;
+        return true;
     }
     
-    if (strcmp(name, "end") == 0) {
-        CHECK_MULTIPLE_DEFINITION(head->end_state != 0, "End state specified multiple times.");
+    if (token_equals(lexer, &name, "end")) {
+        CHECK_MULTIPLE_DEFINITION(head->end_defined, "End state specified multiple times.");
 
         next_token(lexer);
 
         CHECK_TOKEN(TOK_IDENTIFIER, "Content of 'end' has to be an identifier.");
 
-        head->end_state = lexer->curr_token.content;
+        head->end_state = lexer->curr_token;
+        head->end_defined = true;
 
-        TO_END;
+        return true;
     }
 
-    if (strcmp(name, "symbols") == 0) {
+    if (token_equals(lexer, &name, "symbols")) {
         CHECK_MULTIPLE_DEFINITION(head->symbol_len != 0, "Symbols were specified multiple times.");
 
-        head->symbol_len = parse_symbol_list(lexer, &head->symbols);
+        if(!parse_symbol_list(lexer, head->arena, &head->symbols, &head->symbol_len)) {
+            head->symbol_len = 0;
+            return false;
+        }
+
+        // If a symbol is listed twice, the first one is used.
+        init_name_table(&head->symbol_table, head->arena, head->symbol_len);
+        for(size_t i = 0; i < head->symbol_len; ++i) {
+            add_name(&head->symbol_table, lexer, &head->symbols[i], i);
+        }
 
-        TO_END;
+        return true;
     }
 
-    if (strcmp(name, "tape") == 0) {
+    if (token_equals(lexer, &name, "tape")) {
         CHECK_MULTIPLE_DEFINITION(head->tape_len != 0, "Tape was specified multiple times.");
 
-        head->tape_len = parse_symbol_list(lexer, &head->tape_elems);
-
-        TO_END;
+        if(!parse_symbol_list(lexer, head->arena, &head->tape_elems, &head->tape_len)) {
+            head->tape_len = 0;
+            return false;
+        }
     }
 
-end:
-    free((char*)name);
+    return true;
 }
 
 #undef CHECK_MULTIPLE_DEFINITION
 
-static void parse_head(struct Lexer* const lexer, struct Head* head) {
-    *head = (struct Head){0};
+/* Parses everything in front of the delimiter.
+ *
+ * @return false if the body cannot be parsed without symbols.
+ */
+static bool parse_head(struct Lexer* const lexer, struct Head* head, struct Arena* const arena) {
+    *head = (struct Head){
+        .arena = arena
+    };
 
     next_token(lexer);
 
-    for (;lexer->curr_token.type != TOK_DELIMITER; next_token(lexer)) {
+    while (lexer->curr_token.type != TOK_DELIMITER) {
         if (lexer->curr_token.type == TOK_EOF) {
-            // TODO: Way better error
-
-            fprintf(stderr, "End of file reached before end of head.\n");
-            exit(10);
+            print_parser_error(lexer, lexer->curr_token.position, "Invalid Token", "End of file reached before end of head.");
+            return true;
         }
 
         if(lexer->curr_token.type != TOK_IDENTIFIER) {
-            // TODO: Way better error
-
-            fprintf(stderr, "Statement has to start with an identifier.\n");
-            exit(10);
+            print_parser_error(lexer, lexer->curr_token.position, "Invalid Token", "Statement has to start with an identifier.");
+        } else if(parse_statement(lexer, head, lexer->curr_token)) {
+            next_token(lexer);
+            continue;
         }
 
-        parse_statement(lexer, head, lexer->curr_token.content);
+        // A failed statement has already reported its error.
+        // Skips to the start of the next statement: `<identifier> =`
+        do {
+            next_token(lexer);
+        } while (lexer->curr_token.type != TOK_DELIMITER && lexer->curr_token.type != TOK_EOF
+                 && (lexer->curr_token.type != TOK_IDENTIFIER || lexer->next_token.type != TOK_EQUALS));
     }
 
-    if (head->start_state == NULL) {
+    if (!head->start_defined) {
         fprintf(stderr, "A starting state has to be defined.\n");
-        exit(10);
+        ++lexer->errors;
     }
 
     if (head->symbol_len == 0) {
+        // Nothing of the body can be checked without the symbols.
         fprintf(stderr, "A tape needs to have symbols.\n");
-        exit(10);
+        ++lexer->errors;
+        return false;
     }
 
-    if(head->end_state == NULL) {
-        head->end_state = halt;
-
-        fprintf(stdout, "End state not defined. Assuming 'HALT' as end state.\n");
+    if(!head->end_defined) {
+        fprintf(stderr, "End state not defined. Assuming 'HALT' as end state.\n");
     }
 
     if(head->blank_defined) {
-        head->blank_number = find_symbol(head, head->blank);
+        head->blank_number = find_symbol(lexer, head, &head->blank);
+
+        if(head->blank_number == -1) {
+            print_parser_error(lexer, head->blank.position, "Unknown Symbol", "The blank has to be one of the symbols.");
+        }
     }
 
     // If the tape is larger than 0, the tape needs to be corrected.
     if(head->tape_len > 0) {
         head->tape = malloc(sizeof(Symbol) * head->tape_len);
+        if(head->tape == NULL) {
+            out_of_memory();
+        }
 
         for(size_t i = 0; i < head->tape_len; ++i) {
-            head->tape[i] = (Symbol)find_symbol(head, head->tape_elems[i]);
+            head->tape[i] = (Symbol)find_symbol(lexer, head, &head->tape_elems[i]);
+
+            if(head->tape[i] == -1) {
+                print_parser_error(lexer, head->tape_elems[i].position, "Unknown Symbol", "The tape can only contain symbols.");
+            }
         }
     }
+
+    return true;
 }
 
+// A rule is only defined if the name of the next state is not empty.
 struct IntermediateRule {
-    char* next_state;
+    struct Token next_state;
     struct Rule rule;
 };
 
 struct IntermediateState {
-    char* name;
+    struct Token name;
+    // If the state had an error, it can still be referenced, but is not linked.
+    bool failed;
 
     struct IntermediateRule def;
     struct IntermediateRule* rules;
 };
 
-enum Direction stdirection(const char* const string) {
-    if(strcmp(string, "R") == 0 || strcmp(string, "RIGHT") == 0) {
+enum Direction stdirection(const struct Lexer* const lexer, const struct Token* const token) {
+    if(token_equals(lexer, token, "R") || token_equals(lexer, token, "RIGHT")) {
         return RIGHT;
     }
-    if (strcmp(string, "L") == 0 || strcmp(string, "LEFT") == 0) {
+    if (token_equals(lexer, token, "L") || token_equals(lexer, token, "LEFT")) {
         return LEFT;
     }
-    if (strcmp(string, "S") == 0 || strcmp(string, "STAY") == 0) {
+    if (token_equals(lexer, token, "S") || token_equals(lexer, token, "STAY")) {
         return STAY;
     }
 
     return -1;
 }
 
-void parse_rule(struct Lexer* const lexer, const struct Head* head, struct IntermediateRule* rule) {
+bool parse_rule(struct Lexer* const lexer, const struct Head* head, struct IntermediateRule* rule) {
     CHECK_TOKEN(TOK_IDENTIFIER, "A symbol is an identifier.");
 
-    rule->rule.write_symbol = find_symbol(head, lexer->curr_token.content);
+    rule->rule.write_symbol = find_symbol(lexer, head, &lexer->curr_token);
     if(rule->rule.write_symbol == -1) {
-        fprintf(stderr, "Did not find rule with name '%s'.", lexer->curr_token.content);
-        exit(10);
+        print_parser_error(lexer, lexer->curr_token.position, "Unknown Symbol", "This symbol does not exist in the symbol list.");
+        return false;
     }
-    free(lexer->curr_token.content);
 
     next_token(lexer);
 
@@ -264,13 +288,11 @@ void parse_rule(struct Lexer* const lexer, const struct Head* head, struct Inter
 
     CHECK_TOKEN(TOK_IDENTIFIER, "A direction has to be RIGHT/R, LEFT/L, STAY/S");
 
-    if((dir = stdirection(lexer->curr_token.content)) == (enum Direction)-1) {
-        fprintf(stderr, "The direction of a rule has to be RIGHT/R, LEFT/L, STAY/S. \"%s\" is not allowed.\n", lexer->curr_token.content);
-        exit(10);
+    if((dir = stdirection(lexer, &lexer->curr_token)) == (enum Direction)-1) {
+        print_parser_error(lexer, lexer->curr_token.position, "Invalid Direction", "The direction of a rule has to be RIGHT/R, LEFT/L, STAY/S.");
+        return false;
     }
 
-    free(lexer->curr_token.content);
-
     rule->rule.direction = dir;
 
     next_token(lexer);
@@ -280,48 +302,44 @@ void parse_rule(struct Lexer* const lexer, const struct Head* head, struct Inter
     next_token(lexer);
     CHECK_TOKEN(TOK_IDENTIFIER, "The next state has to be an identifier.");
 
-    rule->next_state = lexer->curr_token.content;
+    rule->next_state = lexer->curr_token;
+
+    return true;
 }
 
-void parse_state(struct Lexer* const lexer, const struct Head* head, struct IntermediateState* state) {
+bool parse_state(struct Lexer* const lexer, const struct Head* head, struct IntermediateState* state) {
     CHECK_TOKEN(TOK_IDENTIFIER, "State declaration has to begin with an identifier.");
 
-    state->name = lexer->curr_token.content;
+    state->name = lexer->curr_token;
 
     next_token(lexer);
     CHECK_TOKEN(TOK_OPEN_CURLY, "State declaration has to open with '{'.");
     
-    state->rules = calloc(head->symbol_len, sizeof(struct IntermediateRule));
-    if (state->rules == NULL) {
-        fprintf(stderr, "Not enough memory could be allocated.\n");
-        exit(1);
-    }
+    state->rules = arena_alloc(head->arena, sizeof(struct IntermediateRule) * head->symbol_len);
 
     while (lexer->next_token.type != TOK_CLOSE_CURLY && lexer->next_token.type != TOK_EOF) {
         next_token(lexer);
         if(lexer->curr_token.type != TOK_IDENTIFIER && lexer->curr_token.type != TOK_UNDERSCORE) {
-            // TODO: Add to new error system
-            fprintf(stderr, "Only identifiers are supported as Symbols. The default can be declared with `_`.\n");
-            exit(10);
+            print_parser_error(lexer, lexer->curr_token.position, "Invalid Token", "Only identifiers are supported as Symbols. The default can be declared with `_`.");
+            return false;
         }
 
-        size_t position = lexer->curr_token.type == TOK_UNDERSCORE ? (size_t)-1 : find_symbol(head, lexer->curr_token.content);
+        size_t position = lexer->curr_token.type == TOK_UNDERSCORE ? (size_t)-1 : find_symbol(lexer, head, &lexer->curr_token);
 
         if(lexer->curr_token.type == TOK_IDENTIFIER) {
             if (position == (size_t)-1) {
-                fprintf(stderr, "Symbol %s does not exist in symbol list.\n", lexer->curr_token.content);
-                exit(10);
+                print_parser_error(lexer, lexer->curr_token.position, "Unknown Symbol", "This symbol does not exist in the symbol list.");
+                return false;
             }
 
-            if(state->rules[position].next_state != NULL) {
-                fprintf(stderr, "The rule for '%s' cannot be declared twice.\n", lexer->curr_token.content);
-                exit(10);
+            if(state->rules[position].next_state.length != 0) {
+                print_parser_error(lexer, lexer->curr_token.position, "Multiple Definition", "The rule for this symbol cannot be declared twice.");
+                return false;
             }
-            free(lexer->curr_token.content);
         } else {
-            if(state->def.next_state != NULL) {
-                fprintf(stderr, "The default rule cannot be declared twice.\n");
-                exit(10);
+            if(state->def.next_state.length != 0) {
+                print_parser_error(lexer, lexer->curr_token.position, "Multiple Definition", "The default rule cannot be declared twice.");
+                return false;
             }
         }
 
@@ -329,47 +347,81 @@ void parse_state(struct Lexer* const lexer, const struct Head* head, struct Inte
         CHECK_TOKEN(TOK_EQUALS, "Declaration of statement has to be in the form of <symbol> = <new symbol>, <mov>, <next>.");
 
         next_token(lexer);
-        parse_rule(lexer, head, position == (size_t)-1 ? &state->def : &state->rules[position]);
+        if(!parse_rule(lexer, head, position == (size_t)-1 ? &state->def : &state->rules[position])) {
+            return false;
+        }
     }
     next_token(lexer);
 
     CHECK_TOKEN(TOK_CLOSE_CURLY, "State declaration has to end with a }, but found EOF.");
+
+    return true;
 }
 
 size_t parse_body(struct Lexer* const lexer, struct IntermediateState* states[], const struct Head* const head) {
     size_t size = 16;
     
-    *states = calloc(size, sizeof(struct IntermediateState));
+    *states = arena_alloc(head->arena, sizeof(struct IntermediateState) * size);
     size_t amount = 0;
 
     while(lexer->curr_token.type != TOK_EOF) {
         if(amount >= size) {
-            *states = realloc(*states, size * 2);
+            *states = arena_resize(head->arena, *states, sizeof(struct IntermediateState) * size, sizeof(struct IntermediateState) * size * 2);
+            size = size * 2;
+        }
 
-            if(*states == NULL) {
-                fprintf(stderr, "Error whilst reallocating array.\n");
-                exit(1);
+        struct IntermediateState* const state = &(*states)[amount];
+        *state = (struct IntermediateState){0};
+
+        if(!parse_state(lexer, head, state)) {
+            // The rest of the state is skipped.
+            while(lexer->curr_token.type != TOK_CLOSE_CURLY && lexer->curr_token.type != TOK_EOF) {
+                next_token(lexer);
             }
 
-            size = size * 2;
+            state->failed = true;
+        }
+
+        // Without a name, the state cannot be referenced anyway.
+        if(state->name.length != 0) {
+            ++amount;
         }
 
-        parse_state(lexer, head, &(*states)[amount]);
         next_token(lexer);
-        ++amount;
     }
 
     return amount;
 }
 
-static void link_rules(struct State* const state, const struct IntermediateState* const int_state, const size_t rules_size, 
-                struct State* states, struct IntermediateState* const int_states, const size_t states_size, 
-                const char* const end_state) {
+// Finds the state with the name or returns NULL if it is the end state.
+static struct State* find_next_state(struct Lexer* const lexer, const struct Head* const head, const struct Token* const name,
+                struct State* const states, const struct NameTable* const state_table) {
 
+    if(is_end_state(lexer, head, name)) {
+        return NULL;
+    }
+
+    const size_t index = find_name(state_table, lexer, name);
+    if(index != (size_t)-1) {
+        return states + index;
+    }
+
+    print_parser_error(lexer, name->position, "Unknown State", "This state was used but never defined.");
+    return NULL;
+}
+
+static void link_rules(struct Lexer* const lexer, const struct Head* const head, struct State* const state,
+                const struct IntermediateState* const int_state, struct State* states, const struct NameTable* const state_table) {
+
+    const size_t rules_size = head->symbol_len;
     bool missing_rule = false;
 
+    if(int_state->failed) {
+        return;
+    }
+
     for(size_t i = 0; i < rules_size; ++i) {
-        if(int_state->rules[i].next_state == NULL) {
+        if(int_state->rules[i].next_state.length == 0) {
             // If the rule does not exist, it will be zero initialized, so that it can be recognized later on.
             state->rules[i] = (struct Rule){0};
 
@@ -378,60 +430,21 @@ static void link_rules(struct State* const state, const struct IntermediateState
         }
 
         state->rules[i] = int_state->rules[i].rule;
-
-        // If the next state is the end state, then it does not have
-        // to try to find the correct state and can just keep it as
-        // NULL.
-        if(strcmp(int_state->rules[i].next_state, end_state) != 0) {
-            for(size_t j = 0; j < states_size; ++j) {
-                if(strcmp(int_states[j].name, int_state->rules[i].next_state) != 0) {
-                    continue;
-                }
-
-                state->rules[i].next_state = states + j;
-                break;
-            }
-
-            if(state->rules[i].next_state == NULL) {
-                fprintf(stderr, "The rule '%s' was used but never defined.\n", int_state->rules[i].next_state);
-                exit(10);
-            }
-        }
-
-        free(int_state->rules[i].next_state);
+        state->rules[i].next_state = find_next_state(lexer, head, &int_state->rules[i].next_state, states, state_table);
     }
 
-    if(int_state->def.next_state == NULL) {
+    if(int_state->def.next_state.length == 0) {
         if(missing_rule) {
-            fprintf(stderr, "The state '%s' is not exhaustive. Maybe create an unspecified rule.\n", state->name);
-            exit(10);
+            print_parser_error(lexer, int_state->name.position, "Missing Rule", "The state is not exhaustive. Maybe create an unspecified rule.");
         }
 
         return;
     }
 
-    // Caching the next state as it is quite an expensive task.
-    struct State* def_next_state = NULL;
-
-    // If the next state is the end state, then it does not have
-    // to try to find the correct state and can just keep it as
-    // NULL.
-    if(strcmp(int_state->def.next_state, end_state) != 0) {
-        for(size_t j = 0; j < states_size; ++j) {
-            if(strcmp(int_states[j].name, int_state->def.next_state) != 0) {
-                continue;
-            }
-            def_next_state = states + j;
-            break;
-        }
-        if(def_next_state == NULL) {
-            fprintf(stderr, "The rule '%s' was used but never defined.\n", int_state->def.next_state);
-            exit(10);
-        }
-    }
+    struct State* def_next_state = find_next_state(lexer, head, &int_state->def.next_state, states, state_table);
 
     for(size_t i = 0; i < rules_size; ++i) {
-        if(state->rules[i].next_state != NULL) {
+        if(int_state->rules[i].next_state.length != 0) {
             continue;
         }
 
@@ -441,38 +454,54 @@ static void link_rules(struct State* const state, const struct IntermediateState
     }
 }
 
-struct State* link_states(struct IntermediateState* const int_states, const size_t size, const size_t rule_amount, const char* const end_state) {
-    struct State* states = malloc(sizeof(struct State) * size);
+struct State* link_states(struct Lexer* const lexer, const struct Head* const head, const struct IntermediateState* const int_states, const size_t size,
+                const struct NameTable* const state_table, struct Arena* const arena) {
+    struct State* states = arena_alloc(arena, sizeof(struct State) * size);
+
+    // The rules of all states are stored next to each other.
+    struct Rule* rules = arena_alloc(arena, sizeof(struct Rule) * size * head->symbol_len);
 
+    // The names have to exist before the rules are linked, as they are used in errors.
     for(size_t i = 0; i < size; ++i) {
-        states[i].name = int_states[i].name;
+        states[i].name = token_string(lexer, &int_states[i].name, arena);
+    }
 
-        states[i].rules = malloc(sizeof(struct Rule) * rule_amount);
-        link_rules(&states[i], &int_states[i], rule_amount, states, int_states, size, end_state);
+    for(size_t i = 0; i < size; ++i) {
+        states[i].rules = rules + i * head->symbol_len;
+        link_rules(lexer, head, &states[i], &int_states[i], states, state_table);
     }
 
     return states;
 }
 
-struct State* find_start(struct State* states, const size_t states_size, const char* const start) {
-    for(size_t i = 0; i < states_size; ++i) {
-        if(strcmp(states[i].name, start) == 0) {
-            return &states[i];
-        }
-    }
+struct State* find_start(const struct Lexer* const lexer, struct State* states, const struct NameTable* const state_table, const struct Token* const start) {
+    const size_t index = find_name(state_table, lexer, start);
 
-    return NULL;
+    return index == (size_t)-1 ? NULL : &states[index];
 }
 
-struct TuringMachine* parse(const char* const file_name) {
+struct TuringMachine* parse(const char* const file_name, int* const status) {
     struct Lexer lexer = init_lexer(file_name);
-    if(lexer.fptr == NULL) {
+    if(lexer.source.content == NULL) {
         fprintf(stderr, "File path `%s` does not exist.\n", file_name);
-        exit(1);
+        *status = 1;
+        return NULL;
     }
 
+    // Everything of the machine is allocated from `arena`, while
+    // `scratch` is only needed until the machine is linked.
+    struct Arena arena = {0};
+    struct Arena scratch = {0};
+
     struct Head head;
-    parse_head(&lexer, &head);
+    if(!parse_head(&lexer, &head, &scratch)) {
+        *status = lexer.status != 0 ? lexer.status : 10;
+
+        free(head.tape);
+        free_arena(&scratch);
+        free_lexer(&lexer);
+        return NULL;
+    }
 
     // Remove that delimiter
     next_token(&lexer);
@@ -480,48 +509,56 @@ struct TuringMachine* parse(const char* const file_name) {
     struct IntermediateState* int_states;
     size_t states_size = parse_body(&lexer, &int_states, &head);
 
-    fclose(lexer.fptr);
+    // If a state is defined twice, the first one is used.
+    struct NameTable state_table;
+    init_name_table(&state_table, &scratch, states_size);
+    for(size_t i = 0; i < states_size; ++i) {
+        add_name(&state_table, &lexer, &int_states[i].name, i);
+    }
 
-    struct State* states = link_states(int_states, states_size, head.symbol_len, head.end_state);
+    struct State* states = link_states(&lexer, &head, int_states, states_size, &state_table, &arena);
 
-    // Free all intermediate states
-    for(size_t i = 0; i < states_size; ++i) {
-        free(int_states[i].rules);
+    struct State* start = find_start(&lexer, states, &state_table, &head.start_state);
+    if(start == NULL && head.start_defined) {
+        fprintf(stderr, "Referencing starting state does not exist: '%.*s'.\n", TOKEN_FORMAT(&lexer, head.start_state));
     }
-    free(int_states);
 
-    struct State* start = find_start(states, states_size, head.start_state);
-    if(start == NULL) {
-        fprintf(stderr, "Referencing starting state does not exist: '%s'.\n", head.start_state);
+    if(lexer.errors > 0) {
+        fprintf(stderr, "%zu error%s found.\n", lexer.errors, lexer.errors == 1 ? "" : "s");
+        *status = lexer.status != 0 ? lexer.status : 10;
+
+        free(head.tape);
+        free_arena(&arena);
+        free_arena(&scratch);
+        free_lexer(&lexer);
+        return NULL;
     }
 
-    struct TuringMachine* machine = calloc(1, sizeof(struct TuringMachine));
+    struct TuringMachine* machine = arena_alloc(&arena, sizeof(struct TuringMachine));
     machine->state = start;
+    machine->states = states;
+    machine->states_size = states_size;
 
     if(head.tape_len > 0) {
-        Symbol* symbols = malloc(sizeof(Symbol) * head.tape_len);
-
-        for(size_t i = 0; i < head.tape_len; ++i) {
-            symbols[i] = head.tape[i];
-        }
-
-        machine->tape = init_tape_full(head.blank_number, symbols, head.tape_len);
+        machine->tape = init_tape_full(head.blank_number, head.tape, head.tape_len);
     } else {
         machine->tape = init_tape(head.blank_number);
     }
 
-    machine->tape.symbol_names = head.symbols;
+    // The names of the symbols are the only part of the head that is still needed.
+    char** symbol_names = arena_alloc(&arena, sizeof(char*) * head.symbol_len);
+    for(size_t i = 0; i < head.symbol_len; ++i) {
+        symbol_names[i] = token_string(&lexer, &head.symbols[i], &arena);
+    }
 
-    // Free the head
-    free(head.blank);
-    free(head.tape_elems);
+    machine->tape.symbol_names = symbol_names;
+    machine->tape.symbol_len = head.symbol_len;
 
-    if(head.end_state != halt) {
-        free(head.end_state);
-    }
-    
-    free(head.start_state);
+    // Nothing may be allocated from the arena after it was moved into the machine.
+    machine->arena = arena;
+
+    free_arena(&scratch);
+    free_lexer(&lexer);
 
     return machine;
 }
-
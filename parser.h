@@ -2,4 +2,9 @@
 
 #include "turingmachine.h"
 
-struct TuringMachine* parse(const char* const file_name);
+/* Parses the source file into a machine. All errors are printed.
+ *
+ * @return The machine or NULL if there were errors, in which case
+ *         `status` is set to the exit code for the first error.
+ */
+struct TuringMachine* parse(const char* const file_name, int* const status);
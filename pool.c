@@ -0,0 +1,145 @@
+#include "pool.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <unistd.h>
+
+#include "memory.h"
+
+// The indices from `head` to `tail` that a thread still has to do.
+struct Range {
+    pthread_mutex_t lock;
+    size_t head;
+    size_t tail;
+};
+
+struct Pool {
+    struct Range* ranges;
+    size_t threads;
+
+    void (*job)(void* context, size_t index, size_t worker);
+    void* context;
+};
+
+struct Worker {
+    struct Pool* pool;
+    size_t index;
+};
+
+size_t core_count(void) {
+    const long cores = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return cores > 0 ? (size_t)cores : 1;
+}
+
+static bool take(struct Range* const range, size_t* const job) {
+    pthread_mutex_lock(&range->lock);
+
+    const bool found = range->head < range->tail;
+    if(found) {
+        *job = range->head++;
+    }
+
+    pthread_mutex_unlock(&range->lock);
+    return found;
+}
+
+// Moves the second half of the range of another thread into the own range.
+static bool steal(struct Pool* const pool, const size_t thief, size_t* const job) {
+    for(size_t i = 1; i < pool->threads; ++i) {
+        struct Range* const victim = &pool->ranges[(thief + i) % pool->threads];
+
+        pthread_mutex_lock(&victim->lock);
+
+        const size_t left = victim->tail - victim->head;
+        const size_t amount = (left + 1) / 2;
+        const size_t end = victim->tail;
+        victim->tail -= amount;
+
+        pthread_mutex_unlock(&victim->lock);
+
+        if(amount > 0) {
+            struct Range* const own = &pool->ranges[thief];
+
+            pthread_mutex_lock(&own->lock);
+            own->head = end - amount + 1;
+            own->tail = end;
+            pthread_mutex_unlock(&own->lock);
+
+            *job = end - amount;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void* work(void* const argument) {
+    const struct Worker* const worker = argument;
+    struct Pool* const pool = worker->pool;
+
+    size_t job;
+    while(take(&pool->ranges[worker->index], &job) || steal(pool, worker->index, &job)) {
+        pool->job(pool->context, job, worker->index);
+    }
+
+    return NULL;
+}
+
+size_t pool_size(const size_t jobs, const size_t threads) {
+    const size_t size = threads == 0 ? core_count() : threads;
+
+    if(size > jobs) {
+        return jobs > 0 ? jobs : 1;
+    }
+
+    return size;
+}
+
+void run_pool(const size_t jobs, const size_t size, void (*job)(void* context, size_t index, size_t worker), void* const context) {
+    const size_t threads = pool_size(jobs, size);
+
+    struct Pool pool = {
+        .ranges = malloc(sizeof(struct Range) * threads),
+        .threads = threads,
+        .job = job,
+        .context = context
+    };
+    struct Worker* const workers = malloc(sizeof(struct Worker) * threads);
+    pthread_t* const handles = malloc(sizeof(pthread_t) * threads);
+
+    if(pool.ranges == NULL || workers == NULL || handles == NULL) {
+        out_of_memory();
+    }
+
+    for(size_t i = 0; i < threads; ++i) {
+        pthread_mutex_init(&pool.ranges[i].lock, NULL);
+        pool.ranges[i].head = jobs * i / threads;
+        pool.ranges[i].tail = jobs * (i + 1) / threads;
+
+        workers[i] = (struct Worker){.pool = &pool, .index = i};
+    }
+
+    // The calling thread is the first worker.
+    size_t started = 1;
+    for(; started < threads; ++started) {
+        if(pthread_create(&handles[started], NULL, work, &workers[started]) != 0) {
+            // The other threads steal the jobs of the ones that could not be started.
+            break;
+        }
+    }
+
+    work(&workers[0]);
+
+    for(size_t i = 1; i < started; ++i) {
+        pthread_join(handles[i], NULL);
+    }
+
+    for(size_t i = 0; i < threads; ++i) {
+        pthread_mutex_destroy(&pool.ranges[i].lock);
+    }
+
+    free(pool.ranges);
+    free(workers);
+    free(handles);
+}
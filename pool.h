@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stdlib.h>
+
+/* Calls `job` for every index from 0 to `jobs - 1` on `threads` threads
+ * (the amount of cores if it is 0) and returns once all of them are done.
+ * Each call also gets the index of the thread (less than `pool_size`),
+ * so that the threads can reuse their own memory between jobs.
+ *
+ * Every thread starts with an equal range of the indices. A thread that
+ * finished its range steals the second half of what is left of another one,
+ * so that a few long jobs do not keep the other threads waiting.
+ */
+/* Jobs whose results are written in order are run in windows of this size,
+ * so that the results that wait for an earlier one stay bounded.
+ */
+#define POOL_WINDOW ((size_t)1 << 16)
+
+void run_pool(const size_t jobs, const size_t threads, void (*job)(void* context, size_t index, size_t worker), void* const context);
+
+// The amount of threads that `run_pool` uses.
+size_t pool_size(const size_t jobs, const size_t threads);
+
+// The amount of cores that are available (at least 1).
+size_t core_count(void);
@@ -0,0 +1,185 @@
+#include "runtape.h"
+
+#include <stdint.h>
+
+#include "memory.h"
+
+static void push(struct RunStack* const stack, const Symbol symbol, const size_t length, const Symbol def) {
+    if(stack->size > 0 && stack->runs[stack->size - 1].symbol == symbol) {
+        stack->runs[stack->size - 1].length += length;
+        return;
+    }
+
+    // The blanks at the end of the tape are implicit.
+    if(stack->size == 0 && symbol == def) {
+        return;
+    }
+
+    if(stack->size >= stack->allocated) {
+        stack->allocated = stack->allocated == 0 ? 16 : stack->allocated * 2;
+        stack->runs = realloc(stack->runs, sizeof(struct Run) * stack->allocated);
+
+        if(stack->runs == NULL) {
+            out_of_memory();
+        }
+    }
+
+    stack->runs[stack->size] = (struct Run){
+        .symbol = symbol,
+        .length = length
+    };
+    ++stack->size;
+}
+
+static Symbol pop(struct RunStack* const stack, const Symbol def) {
+    if(stack->size == 0) {
+        return def;
+    }
+
+    struct Run* const run = &stack->runs[stack->size - 1];
+    const Symbol symbol = run->symbol;
+
+    if(--run->length == 0) {
+        --stack->size;
+    }
+
+    return symbol;
+}
+
+struct RunTape init_run_tape(const struct Tape* const tape) {
+    struct RunTape runs = {
+        .current = tape->content[tape->cursor],
+        .def = tape->def,
+        .position = tape->cursor
+    };
+
+    for(size_t i = 0; i < tape->cursor; ++i) {
+        push(&runs.left, tape->content[i], 1, runs.def);
+    }
+
+    for(size_t i = tape->size; i > tape->cursor + 1; --i) {
+        push(&runs.right, tape->content[i - 1], 1, runs.def);
+    }
+
+    return runs;
+}
+
+void run_left(struct RunTape* const tape) {
+    push(&tape->right, tape->current, 1, tape->def);
+    tape->current = pop(&tape->left, tape->def);
+    --tape->position;
+}
+
+void run_right(struct RunTape* const tape) {
+    push(&tape->left, tape->current, 1, tape->def);
+    tape->current = pop(&tape->right, tape->def);
+    ++tape->position;
+}
+
+static size_t sweep(struct RunTape* const tape, struct RunStack* const behind, struct RunStack* const ahead, const Symbol symbol, const size_t max) {
+    const Symbol read = tape->current;
+
+    // The cell of the head and the run in front of it.
+    size_t length = 1;
+    if(ahead->size > 0) {
+        if(ahead->runs[ahead->size - 1].symbol == read) {
+            length += ahead->runs[ahead->size - 1].length;
+        }
+    } else if(read == tape->def) {
+        length = SIZE_MAX;
+    }
+
+    const size_t steps = length < max ? length : max;
+
+    push(behind, symbol, steps, tape->def);
+
+    if(ahead->size > 0 && steps > 1) {
+        struct Run* const run = &ahead->runs[ahead->size - 1];
+        run->length -= steps - 1;
+
+        if(run->length == 0) {
+            --ahead->size;
+        }
+    }
+
+    tape->current = pop(ahead, tape->def);
+
+    return steps;
+}
+
+size_t sweep_left(struct RunTape* const tape, const Symbol symbol, const size_t max) {
+    const size_t steps = sweep(tape, &tape->right, &tape->left, symbol, max);
+    tape->position -= steps;
+
+    return steps;
+}
+
+size_t sweep_right(struct RunTape* const tape, const Symbol symbol, const size_t max) {
+    const size_t steps = sweep(tape, &tape->left, &tape->right, symbol, max);
+    tape->position += steps;
+
+    return steps;
+}
+
+static void fill_window(Symbol* const cells, const size_t amount, const struct RunStack* const stack, const Symbol def) {
+    size_t filled = 0;
+
+    for(size_t i = stack->size; i > 0 && filled < amount; --i) {
+        const struct Run run = stack->runs[i - 1];
+
+        for(size_t j = 0; j < run.length && filled < amount; ++j) {
+            cells[filled++] = run.symbol;
+        }
+    }
+
+    for(; filled < amount; ++filled) {
+        cells[filled] = def;
+    }
+}
+
+struct Tape run_tape_window(const struct RunTape* const tape, const size_t width) {
+    const size_t before = width / 2;
+    const size_t after = width - before - 1;
+
+    Symbol* const content = malloc(sizeof(Symbol) * width);
+    Symbol* const left = malloc(sizeof(Symbol) * (before + 1));
+
+    if(content == NULL || left == NULL) {
+        out_of_memory();
+    }
+
+    // The left side is filled from the head outwards and has to be reversed.
+    fill_window(left, before, &tape->left, tape->def);
+    for(size_t i = 0; i < before; ++i) {
+        content[i] = left[before - 1 - i];
+    }
+    free(left);
+
+    content[before] = tape->current;
+    fill_window(content + before + 1, after, &tape->right, tape->def);
+
+    struct Tape window = init_tape_full(tape->def, content, width);
+    window.cursor = before;
+
+    return window;
+}
+
+void export_run_tape(struct Exporter* const exporter, const struct RunTape* const tape) {
+    for(size_t i = 0; i < tape->left.size; ++i) {
+        export_run(exporter, tape->left.runs[i].symbol, tape->left.runs[i].length);
+    }
+
+    export_run(exporter, tape->current, 1);
+
+    for(size_t i = tape->right.size; i > 0; --i) {
+        export_run(exporter, tape->right.runs[i - 1].symbol, tape->right.runs[i - 1].length);
+    }
+}
+
+void free_run_tape(struct RunTape* const tape) {
+    free(tape->left.runs);
+    free(tape->right.runs);
+
+    tape->left = (struct RunStack){0};
+    tape->right = (struct RunStack){0};
+}
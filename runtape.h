@@ -0,0 +1,63 @@
+#pragma once
+
+#include "export.h"
+#include "tape.h"
+
+struct Run {
+    Symbol symbol;
+    size_t length;
+};
+
+/* The runs on one side of the head.
+ * The last run is the one that is the nearest to the head.
+ */
+struct RunStack {
+    struct Run* runs;
+    size_t size;
+    size_t allocated;
+};
+
+/* A tape that stores runs of the same symbol as (symbol, length) pairs.
+ * The memory that it needs only depends on the amount of runs and not
+ * on the length of the tape.
+ *
+ * The runs are split at the head: Everything that is left of the head
+ * is in `left` and everything that is right of the head is in `right`.
+ * The blanks at the ends of the tape are never stored.
+ */
+struct RunTape {
+    struct RunStack left;
+    struct RunStack right;
+
+    Symbol current;
+    Symbol def;
+
+    // The position of the head relative to the start of the initial tape.
+    long position;
+};
+
+struct RunTape init_run_tape(const struct Tape* const tape);
+
+void run_left(struct RunTape* const tape);
+
+void run_right(struct RunTape* const tape);
+
+/* Writes `symbol` onto the cell of the head and all of the following cells
+ * that contain the same symbol as the head while moving to the left/right.
+ * This is what a state does that stays in itself for the symbol.
+ *
+ * @return The amount of steps this took (at most `max`).
+ */
+size_t sweep_left(struct RunTape* const tape, const Symbol symbol, const size_t max);
+
+size_t sweep_right(struct RunTape* const tape, const Symbol symbol, const size_t max);
+
+/* Converts the cells around the head into a normal tape
+ * with `width / 2` cells on the left of the head.
+ */
+struct Tape run_tape_window(const struct RunTape* const tape, const size_t width);
+
+// Exports the runs of the whole tape from left to right.
+void export_run_tape(struct Exporter* const exporter, const struct RunTape* const tape);
+
+void free_run_tape(struct RunTape* const tape);
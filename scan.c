@@ -0,0 +1,317 @@
+#include "scan.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+
+// The amount of cells that fit into a vector.
+#define LANES (sizeof(__m128i) / sizeof(Symbol))
+#define BYTE_LANES sizeof(__m128i)
+#endif
+
+static int contains(const struct Scan* const scan, const Symbol symbol) {
+    for(size_t i = 0; i < scan->symbols_size; ++i) {
+        if(scan->symbols[i] == symbol) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+#ifdef __SSE2__
+// Returns a mask with all bits of a cell set if the cell is one of the symbols.
+static __m128i match(const struct Scan* const scan, const __m128i* const symbols, const __m128i cells) {
+    __m128i mask = _mm_cmpeq_epi16(cells, symbols[0]);
+
+    for(size_t i = 1; i < scan->symbols_size; ++i) {
+        mask = _mm_or_si128(mask, _mm_cmpeq_epi16(cells, symbols[i]));
+    }
+
+    return mask;
+}
+
+static __m128i match_bytes(const struct Scan* const scan, const __m128i* const symbols, const __m128i cells) {
+    __m128i mask = _mm_cmpeq_epi8(cells, symbols[0]);
+
+    for(size_t i = 1; i < scan->symbols_size; ++i) {
+        mask = _mm_or_si128(mask, _mm_cmpeq_epi8(cells, symbols[i]));
+    }
+
+    return mask;
+}
+#endif
+
+// Counts the cells from `cells[0]` onwards that contain one of the symbols.
+static size_t count_right(const struct Scan* const scan, const Symbol* const cells, const size_t length) {
+    size_t i = 0;
+
+#ifdef __SSE2__
+    __m128i symbols[MAX_SCAN_SYMBOLS];
+    for(size_t j = 0; j < scan->symbols_size; ++j) {
+        symbols[j] = _mm_set1_epi16(scan->symbols[j]);
+    }
+
+    for(; i + LANES <= length; i += LANES) {
+        const __m128i cells_vector = _mm_loadu_si128((const __m128i*)(cells + i));
+        const unsigned int mask = _mm_movemask_epi8(match(scan, symbols, cells_vector));
+
+        if(mask != 0xFFFF) {
+            // Every cell has two bits in the mask.
+            return i + __builtin_ctz(~mask) / sizeof(Symbol);
+        }
+    }
+#endif
+
+    while(i < length && contains(scan, cells[i])) {
+        ++i;
+    }
+
+    return i;
+}
+
+// Counts the cells from `cells[0]` backwards that contain one of the symbols.
+static size_t count_left(const struct Scan* const scan, const Symbol* const cells, const size_t length) {
+    size_t i = 0;
+
+#ifdef __SSE2__
+    __m128i symbols[MAX_SCAN_SYMBOLS];
+    for(size_t j = 0; j < scan->symbols_size; ++j) {
+        symbols[j] = _mm_set1_epi16(scan->symbols[j]);
+    }
+
+    for(; i + LANES <= length; i += LANES) {
+        const __m128i cells_vector = _mm_loadu_si128((const __m128i*)(cells - i - (LANES - 1)));
+        const unsigned int mask = _mm_movemask_epi8(match(scan, symbols, cells_vector));
+
+        if(mask != 0xFFFF) {
+            // The highest cell that does not match is the nearest one.
+            const unsigned int highest = 31 - __builtin_clz(~mask & 0xFFFF);
+            return i + (LANES - 1) - highest / sizeof(Symbol);
+        }
+    }
+#endif
+
+    while(i < length && contains(scan, cells[-(long)i])) {
+        ++i;
+    }
+
+    return i;
+}
+
+static size_t count_right_bytes(const struct Scan* const scan, const uint8_t* const cells, const size_t length) {
+    size_t i = 0;
+
+#ifdef __SSE2__
+    __m128i symbols[MAX_SCAN_SYMBOLS];
+    for(size_t j = 0; j < scan->symbols_size; ++j) {
+        symbols[j] = _mm_set1_epi8((char)scan->symbols[j]);
+    }
+
+    for(; i + BYTE_LANES <= length; i += BYTE_LANES) {
+        const __m128i cells_vector = _mm_loadu_si128((const __m128i*)(cells + i));
+        const unsigned int mask = _mm_movemask_epi8(match_bytes(scan, symbols, cells_vector));
+
+        if(mask != 0xFFFF) {
+            return i + __builtin_ctz(~mask);
+        }
+    }
+#endif
+
+    while(i < length && contains(scan, cells[i])) {
+        ++i;
+    }
+
+    return i;
+}
+
+static size_t count_left_bytes(const struct Scan* const scan, const uint8_t* const cells, const size_t length) {
+    size_t i = 0;
+
+#ifdef __SSE2__
+    __m128i symbols[MAX_SCAN_SYMBOLS];
+    for(size_t j = 0; j < scan->symbols_size; ++j) {
+        symbols[j] = _mm_set1_epi8((char)scan->symbols[j]);
+    }
+
+    for(; i + BYTE_LANES <= length; i += BYTE_LANES) {
+        const __m128i cells_vector = _mm_loadu_si128((const __m128i*)(cells - i - (BYTE_LANES - 1)));
+        const unsigned int mask = _mm_movemask_epi8(match_bytes(scan, symbols, cells_vector));
+
+        if(mask != 0xFFFF) {
+            const unsigned int highest = 31 - __builtin_clz(~mask & 0xFFFF);
+            return i + (BYTE_LANES - 1) - highest;
+        }
+    }
+#endif
+
+    while(i < length && contains(scan, cells[-(long)i])) {
+        ++i;
+    }
+
+    return i;
+}
+
+// Counts the bits from `from` onwards that are the same as `bit`.
+static size_t count_right_bits(const uint64_t* const words, const size_t from, const size_t length, const bool bit) {
+    const uint64_t flip = bit ? ~(uint64_t)0 : 0;
+
+    for(size_t i = 0; i < length;) {
+        const size_t index = from + i;
+        const uint64_t different = (words[index >> 6] ^ flip) >> (index & 63);
+
+        if(different != 0) {
+            const size_t found = i + __builtin_ctzll(different);
+            return found < length ? found : length;
+        }
+
+        i += 64 - (index & 63);
+    }
+
+    return length;
+}
+
+// Counts the bits from `from` backwards that are the same as `bit`.
+static size_t count_left_bits(const uint64_t* const words, const size_t from, const size_t length, const bool bit) {
+    const uint64_t flip = bit ? ~(uint64_t)0 : 0;
+
+    for(size_t i = 0; i < length;) {
+        const size_t index = from - i;
+        const uint64_t different = (words[index >> 6] ^ flip) << (63 - (index & 63));
+
+        if(different != 0) {
+            const size_t found = i + __builtin_clzll(different);
+            return found < length ? found : length;
+        }
+
+        i += (index & 63) + 1;
+    }
+
+    return length;
+}
+
+size_t run_scan(const struct Scan* const scan, struct Tape* const tape, const size_t max) {
+    size_t steps = 0;
+
+    while(steps < max) {
+        const size_t remaining = max - steps;
+
+        if(scan->direction == RIGHT) {
+            const size_t available = tape->size - tape->cursor;
+            const size_t length = available < remaining ? available : remaining;
+            const size_t moved = count_right(scan, tape->content + tape->cursor, length);
+
+            steps += moved;
+
+            // The head ran off the tape, so the tape has to grow.
+            if(moved == available) {
+                tape->cursor += moved - 1;
+                right(tape);
+                continue;
+            }
+
+            tape->cursor += moved;
+            return steps;
+        }
+
+        const size_t available = tape->cursor + 1;
+        const size_t length = available < remaining ? available : remaining;
+        const size_t moved = count_left(scan, tape->content + tape->cursor, length);
+
+        steps += moved;
+
+        if(moved == available) {
+            tape->cursor = 0;
+            left(tape);
+            continue;
+        }
+
+        tape->cursor -= moved;
+        return steps;
+    }
+
+    return steps;
+}
+
+size_t run_scan_bytes(const struct Scan* const scan, struct ByteTape* const tape, const size_t max) {
+    size_t steps = 0;
+
+    while(steps < max) {
+        const size_t remaining = max - steps;
+
+        if(scan->direction == RIGHT) {
+            const size_t available = tape->size - tape->cursor;
+            const size_t length = available < remaining ? available : remaining;
+            const size_t moved = count_right_bytes(scan, tape->content + tape->cursor, length);
+
+            steps += moved;
+            tape->cursor += moved;
+
+            if(moved == available) {
+                grow_byte_right(tape);
+                continue;
+            }
+
+            return steps;
+        }
+
+        const size_t available = tape->cursor + 1;
+        const size_t length = available < remaining ? available : remaining;
+        const size_t moved = count_left_bytes(scan, tape->content + tape->cursor, length);
+
+        steps += moved;
+
+        if(moved == available) {
+            grow_byte_left(tape);
+            continue;
+        }
+
+        tape->cursor -= moved;
+        return steps;
+    }
+
+    return steps;
+}
+
+size_t run_scan_bits(const struct Scan* const scan, struct BitTape* const tape, const size_t max) {
+    // If both symbols are scanned, every cell is moved over.
+    const bool all = scan->symbols_size == 2;
+    const bool bit = scan->symbols[0] != 0;
+
+    size_t steps = 0;
+
+    while(steps < max) {
+        const size_t remaining = max - steps;
+
+        if(scan->direction == RIGHT) {
+            const size_t available = tape->size * 64 - tape->cursor;
+            const size_t length = available < remaining ? available : remaining;
+            const size_t moved = all ? length : count_right_bits(tape->words, tape->cursor, length, bit);
+
+            steps += moved;
+            tape->cursor += moved;
+
+            if(moved == available) {
+                grow_bit_right(tape);
+                continue;
+            }
+
+            return steps;
+        }
+
+        const size_t available = tape->cursor + 1;
+        const size_t length = available < remaining ? available : remaining;
+        const size_t moved = all ? length : count_left_bits(tape->words, tape->cursor, length, bit);
+
+        steps += moved;
+
+        if(moved == available) {
+            grow_bit_left(tape);
+            continue;
+        }
+
+        tape->cursor -= moved;
+        return steps;
+    }
+
+    return steps;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "turingmachine.h"
+#include "narrowtape.h"
+
+#define MAX_SCAN_SYMBOLS 4
+
+/* The symbols that a state moves over without changing
+ * them or itself. If `direction` is STAY, the state does not scan.
+ */
+struct Scan {
+    enum Direction direction;
+
+    size_t symbols_size;
+    Symbol symbols[MAX_SCAN_SYMBOLS];
+};
+
+/* Moves the head over all of the cells that contain one of the symbols
+ * of the scan, including the blanks that are beyond the current tape.
+ * Every cell that is moved over counts as a step.
+ *
+ * @return The amount of steps this took (at most `max`).
+ */
+size_t run_scan(const struct Scan* const scan, struct Tape* const tape, const size_t max);
+
+size_t run_scan_bytes(const struct Scan* const scan, struct ByteTape* const tape, const size_t max);
+
+size_t run_scan_bits(const struct Scan* const scan, struct BitTape* const tape, const size_t max);
@@ -0,0 +1,305 @@
+#include "table.h"
+
+#include "memory.h"
+
+static unsigned int bits_for(size_t amount) {
+    unsigned int bits = 1;
+    while(bits < 16 && ((size_t)1 << bits) < amount) {
+        ++bits;
+    }
+
+    return bits;
+}
+
+static void add_scan_symbol(struct Scan* const scan, const enum Direction direction, const Symbol symbol) {
+    // Only the symbols of one direction can be scanned.
+    if(scan->direction != STAY && scan->direction != direction) {
+        return;
+    }
+
+    scan->direction = direction;
+
+    if(scan->symbols_size < MAX_SCAN_SYMBOLS) {
+        scan->symbols[scan->symbols_size] = symbol;
+    }
+    ++scan->symbols_size;
+}
+
+int compile_table(struct TransitionTable* const table, const struct TuringMachine* const machine) {
+    const size_t symbol_len = machine->tape.symbol_len;
+    const unsigned int symbol_bits = bits_for(symbol_len);
+
+    // The halt state also needs an ID which is why it has to be `<` and not `<=`.
+    const size_t capacity = (size_t)1 << (sizeof(PackedRule) * 8 - 2 - symbol_bits);
+    if(machine->states_size >= capacity) {
+        return 0;
+    }
+
+    PackedRule* rules = malloc(sizeof(PackedRule) * machine->states_size * symbol_len);
+    if(rules == NULL) {
+        out_of_memory();
+    }
+
+    struct Scan* scans = malloc(sizeof(struct Scan) * machine->states_size);
+    if(scans == NULL) {
+        out_of_memory();
+    }
+
+    const StateId halt = machine->states_size;
+
+    for(size_t i = 0; i < machine->states_size; ++i) {
+        scans[i] = (struct Scan){
+            .direction = STAY
+        };
+
+        for(size_t j = 0; j < symbol_len; ++j) {
+            const struct Rule rule = machine->states[i].rules[j];
+            const StateId next = rule.next_state == NULL ? halt : (StateId)(rule.next_state - machine->states);
+
+            if(next == i && rule.write_symbol == (Symbol)j && rule.direction != STAY) {
+                add_scan_symbol(&scans[i], rule.direction, j);
+            }
+
+            rules[i * symbol_len + j] = (PackedRule)next << (symbol_bits + 2)
+                                      | (PackedRule)rule.direction << symbol_bits
+                                      | (PackedRule)rule.write_symbol;
+        }
+    }
+
+    for(size_t i = 0; i < machine->states_size; ++i) {
+        // Too many symbols to compare them at once.
+        if(scans[i].symbols_size > MAX_SCAN_SYMBOLS) {
+            scans[i].direction = STAY;
+        }
+    }
+
+    NarrowRule* narrow_rules = NULL;
+    if(machine->states_size < (size_t)1 << (sizeof(NarrowRule) * 8 - 2 - symbol_bits)) {
+        narrow_rules = malloc(sizeof(NarrowRule) * machine->states_size * symbol_len);
+        if(narrow_rules == NULL) {
+            out_of_memory();
+        }
+
+        for(size_t i = 0; i < machine->states_size * symbol_len; ++i) {
+            narrow_rules[i] = (NarrowRule)rules[i];
+        }
+    }
+
+    *table = (struct TransitionTable){
+        .rules = rules,
+        .narrow_rules = narrow_rules,
+        .scans = scans,
+        .states_size = machine->states_size,
+        .symbol_len = symbol_len,
+        .symbol_bits = symbol_bits,
+        .start = machine->state == NULL ? halt : (StateId)(machine->state - machine->states),
+        .halt = halt
+    };
+
+    return 1;
+}
+
+size_t run_table(const struct TransitionTable* const table, struct Tape* const tape, StateId* const state, const size_t max_iter) {
+    // Everything that is needed in the loop is kept in locals
+    // so that the compiler can keep them in registers.
+    const PackedRule* const rules = table->rules;
+    const struct Scan* const scans = table->scans;
+    const size_t symbol_len = table->symbol_len;
+    const StateId halt = table->halt;
+
+    StateId current = *state;
+    size_t count = 0;
+
+    while(current != halt && count < max_iter) {
+        if(scans[current].direction != STAY) {
+            count += run_scan(&scans[current], tape, max_iter - count);
+
+            if(count >= max_iter) {
+                break;
+            }
+        }
+
+        const PackedRule rule = rules[current * symbol_len + tape->content[tape->cursor]];
+
+        tape->content[tape->cursor] = RULE_SYMBOL(table, rule);
+
+        switch(RULE_DIRECTION(table, rule)) {
+        case RIGHT:
+            right(tape);
+            break;
+        case LEFT:
+            left(tape);
+            break;
+        case STAY:
+            // Do nothing
+            break;
+        }
+
+        current = RULE_NEXT(table, rule);
+        ++count;
+    }
+
+    *state = current;
+
+    return count;
+}
+
+size_t run_table_bytes(const struct TransitionTable* const table, struct ByteTape* const tape, StateId* const state, const size_t max_iter) {
+    const PackedRule* const rules = table->rules;
+    const NarrowRule* const narrow_rules = table->narrow_rules;
+    const struct Scan* const scans = table->scans;
+    const size_t symbol_len = table->symbol_len;
+    const StateId halt = table->halt;
+
+    StateId current = *state;
+    size_t count = 0;
+
+    while(current != halt && count < max_iter) {
+        if(scans[current].direction != STAY) {
+            count += run_scan_bytes(&scans[current], tape, max_iter - count);
+
+            if(count >= max_iter) {
+                break;
+            }
+        }
+
+        const size_t index = current * symbol_len + tape->content[tape->cursor];
+        const PackedRule rule = narrow_rules != NULL ? narrow_rules[index] : rules[index];
+
+        tape->content[tape->cursor] = (uint8_t)RULE_SYMBOL(table, rule);
+
+        switch(RULE_DIRECTION(table, rule)) {
+        case RIGHT:
+            if(++tape->cursor == tape->size) {
+                grow_byte_right(tape);
+            }
+            break;
+        case LEFT:
+            if(tape->cursor == 0) {
+                grow_byte_left(tape);
+            } else {
+                --tape->cursor;
+            }
+            break;
+        case STAY:
+            // Do nothing
+            break;
+        }
+
+        current = RULE_NEXT(table, rule);
+        ++count;
+    }
+
+    *state = current;
+
+    return count;
+}
+
+size_t run_table_bits(const struct TransitionTable* const table, struct BitTape* const tape, StateId* const state, const size_t max_iter) {
+    const PackedRule* const rules = table->rules;
+    const NarrowRule* const narrow_rules = table->narrow_rules;
+    const struct Scan* const scans = table->scans;
+    const size_t symbol_len = table->symbol_len;
+    const StateId halt = table->halt;
+
+    StateId current = *state;
+    size_t count = 0;
+
+    while(current != halt && count < max_iter) {
+        if(scans[current].direction != STAY) {
+            count += run_scan_bits(&scans[current], tape, max_iter - count);
+
+            if(count >= max_iter) {
+                break;
+            }
+        }
+
+        const size_t index = current * symbol_len + BIT_GET(tape, tape->cursor);
+        const PackedRule rule = narrow_rules != NULL ? narrow_rules[index] : rules[index];
+
+        BIT_SET(tape, tape->cursor, RULE_SYMBOL(table, rule));
+
+        switch(RULE_DIRECTION(table, rule)) {
+        case RIGHT:
+            if(++tape->cursor == tape->size * 64) {
+                grow_bit_right(tape);
+            }
+            break;
+        case LEFT:
+            if(tape->cursor == 0) {
+                grow_bit_left(tape);
+            } else {
+                --tape->cursor;
+            }
+            break;
+        case STAY:
+            // Do nothing
+            break;
+        }
+
+        current = RULE_NEXT(table, rule);
+        ++count;
+    }
+
+    *state = current;
+
+    return count;
+}
+
+size_t run_table_runs(const struct TransitionTable* const table, struct RunTape* const tape, StateId* const state, const size_t max_iter) {
+    const PackedRule* const rules = table->rules;
+    const size_t symbol_len = table->symbol_len;
+    const StateId halt = table->halt;
+
+    StateId current = *state;
+    size_t count = 0;
+
+    while(current != halt && count < max_iter) {
+        const PackedRule rule = rules[current * symbol_len + tape->current];
+        const StateId next = RULE_NEXT(table, rule);
+
+        switch(RULE_DIRECTION(table, rule)) {
+        case RIGHT:
+            if(next == current) {
+                count += sweep_right(tape, RULE_SYMBOL(table, rule), max_iter - count);
+                continue;
+            }
+
+            tape->current = RULE_SYMBOL(table, rule);
+            run_right(tape);
+            break;
+        case LEFT:
+            if(next == current) {
+                count += sweep_left(tape, RULE_SYMBOL(table, rule), max_iter - count);
+                continue;
+            }
+
+            tape->current = RULE_SYMBOL(table, rule);
+            run_left(tape);
+            break;
+        case STAY:
+            tape->current = RULE_SYMBOL(table, rule);
+            break;
+        }
+
+        current = next;
+        ++count;
+    }
+
+    *state = current;
+
+    return count;
+}
+
+const struct State* table_state(const struct TuringMachine* const machine, const struct TransitionTable* const table, const StateId state) {
+    return state == table->halt ? NULL : &machine->states[state];
+}
+
+void free_table(struct TransitionTable* const table) {
+    free(table->rules);
+    free(table->narrow_rules);
+    free(table->scans);
+    table->rules = NULL;
+    table->narrow_rules = NULL;
+    table->scans = NULL;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "turingmachine.h"
+#include "runtape.h"
+#include "narrowtape.h"
+#include "scan.h"
+
+typedef uint32_t StateId;
+
+/* A rule packed into a single integer:
+ *
+ *   | next state | direction (2 bits) | write symbol (symbol_bits) |
+ *
+ * The amount of bits for the symbol depends on the amount of symbols
+ * so that as many bits as possible are left for the state.
+ */
+typedef uint32_t PackedRule;
+
+// The same layout in 16 bits for small machines so that more rules fit into the cache.
+typedef uint16_t NarrowRule;
+
+/* The compiled form of the states of a Turing Machine.
+ * All of the rules are stored state-major in a single array
+ * so that a step only needs a single lookup:
+ *
+ *   rules[state * symbol_len + symbol]
+ *
+ * The halt state does not have any rules and has the ID `states_size`.
+ *
+ * States that keep moving in one direction over some symbols without
+ * changing them (e.g. to find the end of the input) are stored in `scans`.
+ *
+ * If the rules also fit into 16 bits, they are stored in `narrow_rules`
+ * as well, otherwise it is NULL.
+ */
+struct TransitionTable {
+    PackedRule* rules;
+    NarrowRule* narrow_rules;
+    struct Scan* scans;
+
+    size_t states_size;
+    size_t symbol_len;
+
+    unsigned int symbol_bits;
+
+    StateId start;
+    StateId halt;
+};
+
+#define RULE_SYMBOL(table, rule) ((Symbol)((rule) & (((PackedRule)1 << (table)->symbol_bits) - 1)))
+#define RULE_DIRECTION(table, rule) ((enum Direction)(((rule) >> (table)->symbol_bits) & 3))
+#define RULE_NEXT(table, rule) ((StateId)((rule) >> ((table)->symbol_bits + 2)))
+
+/* Compiles the states of the machine into a transition table.
+ *
+ * @return 1 if it was successful and 0 if the machine
+ *         has too many states to be packed.
+ */
+int compile_table(struct TransitionTable* const table, const struct TuringMachine* const machine);
+
+/* Runs the table on the tape until the halt state is reached
+ * or `max_iter` steps have been executed.
+ *
+ * @return The amount of steps that were executed.
+ */
+size_t run_table(const struct TransitionTable* const table, struct Tape* const tape, StateId* const state, const size_t max_iter);
+
+/* Runs the table on a tape with one byte per cell.
+ *
+ * @return The amount of steps that were executed.
+ */
+size_t run_table_bytes(const struct TransitionTable* const table, struct ByteTape* const tape, StateId* const state, const size_t max_iter);
+
+// Runs the table on a tape with one bit per cell.
+size_t run_table_bits(const struct TransitionTable* const table, struct BitTape* const tape, StateId* const state, const size_t max_iter);
+
+/* Runs the table on a run-length encoded tape.
+ * If a state stays in itself while moving, the whole run
+ * under the head is being processed in a single step.
+ *
+ * @return The amount of steps that were executed.
+ */
+size_t run_table_runs(const struct TransitionTable* const table, struct RunTape* const tape, StateId* const state, const size_t max_iter);
+
+const struct State* table_state(const struct TuringMachine* const machine, const struct TransitionTable* const table, const StateId state);
+
+void free_table(struct TransitionTable* const table);
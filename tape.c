@@ -3,24 +3,99 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "memory.h"
+
+#define CHUNK_CELLS (MEMORY_CHUNK / sizeof(Symbol))
+
 static void set_default(Symbol* const start, const size_t length, const Symbol def) {
     for(size_t i = 0; i < length; i++){
         ((Symbol*)start)[i] = def;
     }
 }
 
-inline struct Tape init_tape_full(const Symbol def, Symbol* content, const size_t size) {
-    return (struct Tape){
+static size_t round_chunk(const size_t cells) {
+    return (cells + CHUNK_CELLS - 1) / CHUNK_CELLS * CHUNK_CELLS;
+}
+
+/* Reserves address space for the tape without using any memory.
+ * Half of it is available to the left and the other half to the right of the origin.
+ *
+ * @return 1 if the space could be reserved and 0 otherwise.
+ */
+static int reserve(struct Tape* const tape, const size_t cells) {
+    size_t bytes;
+    Symbol* const range = reserve_memory(&bytes, cells * sizeof(Symbol) * 2);
+
+    if(range == NULL) {
+        return 0;
+    }
+
+    tape->reserved = range;
+    tape->reserved_size = bytes / sizeof(Symbol);
+    return 1;
+}
+
+/* Makes a part of the reserved space usable and fills it with the default symbol.
+ *
+ * @return 1 if it was successful and 0 otherwise.
+ */
+static int commit(Symbol* const start, const size_t cells, const Symbol def) {
+    if(!commit_memory(start, cells * sizeof(Symbol))) {
+        return 0;
+    }
+
+    // Fresh pages are already zeroed.
+    if(def != 0) {
+        set_default(start, cells, def);
+    }
+
+    return 1;
+}
+
+/* Moves the content into a reserved range of the address space
+ * with the start of the content at its origin.
+ */
+static void move_to_reserve(struct Tape* const tape) {
+    const size_t committed = round_chunk(tape->size > 0 ? tape->size : 1);
+
+    if(!reserve(tape, committed)) {
+        return;
+    }
+
+    Symbol* const origin = tape->reserved + tape->reserved_size / 2;
+    if(!commit(origin, committed, tape->def)) {
+        release_memory(tape->reserved, tape->reserved_size * sizeof(Symbol));
+        tape->reserved = NULL;
+        tape->reserved_size = 0;
+        return;
+    }
+
+    memcpy(origin, tape->content, sizeof(Symbol) * tape->size);
+    free(tape->content);
+
+    tape->content = origin;
+    tape->size = committed;
+}
+
+struct Tape init_tape_full(const Symbol def, Symbol* content, const size_t size) {
+    struct Tape tape = {
         .content = content,
         .size = size,
         .def = def,
         .cursor = 0
     };
+
+    move_to_reserve(&tape);
+
+    return tape;
 }
 
 struct Tape init_tape(const Symbol def) {
     const size_t size = 16;
     Symbol* const content = malloc(sizeof(Symbol) * size);
+    if(content == NULL) {
+        out_of_memory();
+    }
 
     set_default(content, size, def);
 
@@ -30,18 +105,91 @@ struct Tape init_tape(const Symbol def) {
     return tape;
 }
 
+struct Tape init_tape_blank(const Symbol def, const size_t size) {
+    struct Tape tape = {
+        .def = def,
+        .cursor = 0
+    };
+
+    const size_t committed = round_chunk(size > 0 ? size : 1);
+
+    if(reserve(&tape, committed)) {
+        Symbol* const origin = tape.reserved + tape.reserved_size / 2;
+
+        if(commit(origin, committed, def)) {
+            tape.content = origin;
+            tape.size = committed;
+            return tape;
+        }
+
+        release_memory(tape.reserved, tape.reserved_size * sizeof(Symbol));
+        tape.reserved = NULL;
+        tape.reserved_size = 0;
+    }
+
+    tape.size = size > 0 ? size : 1;
+    tape.content = malloc(sizeof(Symbol) * tape.size);
+    if(tape.content == NULL) {
+        out_of_memory();
+    }
+    set_default(tape.content, tape.size, def);
+
+    return tape;
+}
+
+void reset_tape(struct Tape* const tape, const size_t from, const size_t to, const size_t size) {
+    set_default(tape->content + from, to - from, tape->def);
+
+    // The tape grows like it does when the head moves past its end.
+    while(tape->size - tape->size / 2 < size) {
+        tape->cursor = tape->size - 1;
+        right(tape);
+    }
+
+    // Otherwise a tape that is reused grows every time the head moves left of the first cell.
+    tape->cursor = tape->size / 2;
+}
+
+struct Tape copy_tape(const struct Tape* const tape) {
+    Symbol* const content = malloc(sizeof(Symbol) * tape->size);
+    if(content == NULL) {
+        out_of_memory();
+    }
+
+    memcpy(content, tape->content, sizeof(Symbol) * tape->size);
+
+    struct Tape copy = init_tape_full(tape->def, content, tape->size);
+    copy.cursor = tape->cursor;
+    copy.symbol_names = tape->symbol_names;
+    copy.symbol_len = tape->symbol_len;
+
+    return copy;
+}
+
 void left(struct Tape* const tape) {
     if(tape->cursor > 0) {
         --tape->cursor;
         return;
     }
 
+    if(tape->reserved != NULL) {
+        const size_t available = tape->content - tape->reserved;
+        const size_t grow = tape->size < available ? tape->size : available;
+
+        if(grow == 0 || !commit(tape->content - grow, grow, tape->def)) {
+            out_of_memory();
+        }
+
+        tape->content -= grow;
+        tape->cursor = grow - 1;
+        tape->size += grow;
+        return;
+    }
+
     Symbol* new = malloc(sizeof(Symbol) * tape->size * 2);
 
     if(!new) {
-        fprintf(stderr, "Not enough memory\n");
-
-        exit(EXIT_FAILURE);
+        out_of_memory();
     }
 
     memcpy(new + tape->size, tape->content, sizeof(Symbol) * tape->size);
@@ -60,12 +208,22 @@ void right(struct Tape* const tape) {
         return;
     }
 
+    if(tape->reserved != NULL) {
+        const size_t available = (tape->reserved + tape->reserved_size) - (tape->content + tape->size);
+        const size_t grow = tape->size < available ? tape->size : available;
+
+        if(grow == 0 || !commit(tape->content + tape->size, grow, tape->def)) {
+            out_of_memory();
+        }
+
+        tape->size += grow;
+        return;
+    }
+
     Symbol* new = realloc(tape->content, sizeof(Symbol) * tape->size * 2);
 
     if(!new) {
-        fprintf(stderr, "Not enough memory\n");
-
-        exit(EXIT_FAILURE);
+        out_of_memory();
     }
 
     tape->content = new;
@@ -79,7 +237,14 @@ void write(struct Tape* const tape, const Symbol symbol) {
 }
 
 void free_tape(struct Tape* const tape) {
-    free(tape->content);
+    if(tape->reserved != NULL) {
+        release_memory(tape->reserved, tape->reserved_size * sizeof(Symbol));
 
-    free(tape);
+        tape->reserved = NULL;
+        tape->content = NULL;
+        return;
+    }
+
+    free(tape->content);
+    tape->content = NULL;
 }
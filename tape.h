@@ -9,18 +9,41 @@ struct Tape {
     size_t size;
 
     char** symbol_names;
+    size_t symbol_len;
 
     //
 
     Symbol def;
 
     size_t cursor;
+
+    // If the tape could reserve a range of the address space, the
+    // content is a window inside of it that grows in both directions
+    // without moving. Otherwise `reserved` is NULL and the content is
+    // reallocated on the heap.
+    Symbol* reserved;
+    size_t reserved_size;
 };
 
 struct Tape init_tape_full(const Symbol def, Symbol* content, const size_t size);
 
 struct Tape init_tape(const Symbol def);
 
+/* Creates a tape with at least `size` blank cells and the head on the first one,
+ * so that the content can be written directly into the storage of the tape.
+ */
+struct Tape init_tape_blank(const Symbol def, const size_t size);
+
+/* Makes the cells from `from` to `to` blank again, so that the memory can
+ * be reused (all other cells have to be blank already). The head is placed
+ * in the middle, with at least `size` cells from the head to the end.
+ */
+void reset_tape(struct Tape* const tape, const size_t from, const size_t to, const size_t size);
+
+/* Creates a tape with the same content, cursor and symbols.
+ */
+struct Tape copy_tape(const struct Tape* const tape);
+
 void left(struct Tape* const tape);
 
 void right(struct Tape* const tape);
@@ -0,0 +1,159 @@
+#include "tapefile.h"
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "memory.h"
+
+static void replace_tape(struct Tape* const tape, struct Tape* const loaded) {
+    loaded->symbol_names = tape->symbol_names;
+    loaded->symbol_len = tape->symbol_len;
+
+    free_tape(tape);
+    *tape = *loaded;
+}
+
+int load_tape_raw(struct Tape* const tape, const char* const file_name) {
+    struct MappedFile file;
+    if(!map_file(&file, file_name)) {
+        return 0;
+    }
+
+    const unsigned char* const bytes = (const unsigned char*)file.content;
+    struct Tape loaded = init_tape_blank(tape->def, file.size);
+
+    for(size_t i = 0; i < file.size; ++i) {
+        if(bytes[i] >= tape->symbol_len) {
+            fprintf(stderr, "\033[31mThe byte %u at position %zu of `%s` is not a symbol.\033[0m\n", bytes[i], i, file_name);
+            exit(10);
+        }
+
+        loaded.content[i] = (Symbol)bytes[i];
+    }
+
+    unmap_file(&file);
+    replace_tape(tape, &loaded);
+
+    return 1;
+}
+
+// Returns the slot of the name, which contains `(size_t)-1` if the name is not a symbol.
+static size_t* find_slot(const struct SymbolLookup* const lookup, const char* const name, const size_t length) {
+    size_t i = hash_slot(name, length, lookup->allocated);
+
+    while(lookup->slots[i] != (size_t)-1) {
+        const size_t symbol = lookup->slots[i];
+
+        if(lookup->lengths[symbol] == length && memcmp(lookup->names[symbol], name, length) == 0) {
+            break;
+        }
+
+        i = (i + 1) & (lookup->allocated - 1);
+    }
+
+    return &lookup->slots[i];
+}
+
+struct SymbolLookup init_symbol_lookup(const struct Tape* const tape) {
+    struct SymbolLookup lookup = {
+        .names = (const char* const*)tape->symbol_names,
+        .allocated = 16
+    };
+
+    while(lookup.allocated < tape->symbol_len * 2) {
+        lookup.allocated *= 2;
+    }
+
+    lookup.lengths = malloc(sizeof(size_t) * tape->symbol_len);
+    lookup.slots = malloc(sizeof(size_t) * lookup.allocated);
+    if(lookup.lengths == NULL || lookup.slots == NULL) {
+        out_of_memory();
+    }
+
+    memset(lookup.slots, 0xFF, sizeof(size_t) * lookup.allocated);
+
+    for(size_t i = 0; i < tape->symbol_len; ++i) {
+        lookup.lengths[i] = strlen(tape->symbol_names[i]);
+
+        // If a symbol is listed twice, the first one is used.
+        size_t* const slot = find_slot(&lookup, tape->symbol_names[i], lookup.lengths[i]);
+        if(*slot == (size_t)-1) {
+            *slot = i;
+        }
+    }
+
+    return lookup;
+}
+
+void free_symbol_lookup(struct SymbolLookup* const lookup) {
+    free(lookup->lengths);
+    free(lookup->slots);
+
+    lookup->lengths = NULL;
+    lookup->slots = NULL;
+}
+
+static bool is_separator(const char c) {
+    return isspace((unsigned char)c) || c == ',';
+}
+
+bool decode_names(const struct SymbolLookup* const lookup, const char* const text, const size_t size, Symbol* const cells, size_t* const count, size_t* const error) {
+    size_t i = 0;
+    *count = 0;
+
+    while(i < size) {
+        if(is_separator(text[i])) {
+            ++i;
+            continue;
+        }
+
+        const size_t start = i;
+        while(i < size && !is_separator(text[i])) {
+            ++i;
+        }
+
+        const size_t symbol = *find_slot(lookup, text + start, i - start);
+        if(symbol == (size_t)-1) {
+            *error = start;
+            return false;
+        }
+
+        cells[*count] = (Symbol)symbol;
+        ++*count;
+    }
+
+    return true;
+}
+
+int load_tape_names(struct Tape* const tape, const char* const file_name) {
+    struct MappedFile file;
+    if(!map_file(&file, file_name)) {
+        return 0;
+    }
+
+    struct SymbolLookup lookup = init_symbol_lookup(tape);
+
+    // Every name is followed by a separator, so this is the most cells there can be.
+    struct Tape loaded = init_tape_blank(tape->def, file.size / 2 + 1);
+
+    size_t cells;
+    size_t error;
+    if(!decode_names(&lookup, file.content, file.size, loaded.content, &cells, &error)) {
+        size_t end = error;
+        while(end < file.size && !is_separator(file.content[end])) {
+            ++end;
+        }
+
+        fprintf(stderr, "\033[31mCell %zu of `%s` is not a symbol: '%.*s'.\033[0m\n", cells, file_name, (int)(end - error), file.content + error);
+        exit(10);
+    }
+
+    free_symbol_lookup(&lookup);
+    unmap_file(&file);
+
+    replace_tape(tape, &loaded);
+
+    return 1;
+}
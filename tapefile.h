@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdbool.h>
+
+#include "tape.h"
+
+/* The initial tape can be read from a separate file instead of the head:
+ *
+ *  - raw:   Every byte is the index of a symbol.
+ *  - names: The names of the symbols, separated by whitespace or commas.
+ *
+ * The file is mapped and decoded directly into the cells of the new tape,
+ * which replaces the content of `tape` (the symbols and blank are kept).
+ * The head starts on the first cell.
+ *
+ * @return 1 if it was successful and 0 if the file could not be opened.
+ *         Cells that are not symbols end the program with an error.
+ */
+int load_tape_raw(struct Tape* const tape, const char* const file_name);
+
+int load_tape_names(struct Tape* const tape, const char* const file_name);
+
+// A small open-addressing table from the names of the symbols to their index.
+struct SymbolLookup {
+    const char* const* names;
+    size_t* lengths;
+
+    size_t* slots;
+    size_t allocated;
+};
+
+struct SymbolLookup init_symbol_lookup(const struct Tape* const tape);
+
+/* Decodes the names of symbols (separated by whitespace or commas) into `cells`,
+ * which needs space for `size / 2 + 1` cells.
+ *
+ * @return true if it was successful and false if a name is not a symbol.
+ *         `count` is set to the amount of cells that were decoded and
+ *         `error` to the position of the name that is not a symbol.
+ */
+bool decode_names(const struct SymbolLookup* const lookup, const char* const text, const size_t size, Symbol* const cells, size_t* const count, size_t* const error);
+
+void free_symbol_lookup(struct SymbolLookup* const lookup);
@@ -0,0 +1,205 @@
+#include "threaded.h"
+
+#include "memory.h"
+
+void compile_threaded(struct ThreadedProgram* const program, const struct TransitionTable* const table) {
+    const size_t symbol_len = table->symbol_len;
+    const size_t states = table->states_size;
+
+    struct ThreadedRule* const rules = malloc(sizeof(struct ThreadedRule) * (states + 1) * symbol_len);
+    if(rules == NULL) {
+        out_of_memory();
+    }
+
+    for(size_t i = 0; i < states; ++i) {
+        for(size_t j = 0; j < symbol_len; ++j) {
+            const PackedRule rule = table->rules[i * symbol_len + j];
+            const Symbol symbol = RULE_SYMBOL(table, rule);
+
+            enum TransitionKind kind;
+            switch(RULE_DIRECTION(table, rule)) {
+            case LEFT:
+                kind = symbol == (Symbol)j ? KIND_LEFT : KIND_WRITE_LEFT;
+                break;
+            case RIGHT:
+                kind = symbol == (Symbol)j ? KIND_RIGHT : KIND_WRITE_RIGHT;
+                break;
+            default:
+                kind = symbol == (Symbol)j ? KIND_STAY : KIND_WRITE_STAY;
+                break;
+            }
+
+            rules[i * symbol_len + j] = (struct ThreadedRule){
+                .next = RULE_NEXT(table, rule) * symbol_len,
+                .write_symbol = symbol,
+                .kind = kind
+            };
+        }
+    }
+
+    for(size_t j = 0; j < symbol_len; ++j) {
+        rules[states * symbol_len + j] = (struct ThreadedRule){
+            .kind = KIND_HALT
+        };
+    }
+
+    *program = (struct ThreadedProgram){
+        .rules = rules,
+        .symbol_len = symbol_len,
+        .halt = table->halt
+    };
+}
+
+// Synchronizes the local copies with the tape when it has to grow.
+#define MOVE_LEFT() if(cursor == 0) { \
+            tape->cursor = cursor; \
+            left(tape); \
+            content = tape->content; \
+            cursor = tape->cursor; \
+        } else { \
+            --cursor; \
+        }
+
+#define MOVE_RIGHT() if(cursor + 1 == tape->size) { \
+            tape->cursor = cursor; \
+            right(tape); \
+            content = tape->content; \
+            cursor = tape->cursor; \
+        } else { \
+            ++cursor; \
+        }
+
+#ifdef __GNUC__
+
+#define DISPATCH() do { \
+            if(remaining == 0) goto stop; \
+            --remaining; \
+            rule = &rules[next + content[cursor]]; \
+            goto *rule->handler; \
+        } while(0)
+
+size_t run_threaded(struct ThreadedProgram* const program, struct Tape* const tape, StateId* const state, const size_t max_iter) {
+    static const void* const handlers[] = {
+        [KIND_WRITE_LEFT] = &&write_left,
+        [KIND_WRITE_RIGHT] = &&write_right,
+        [KIND_WRITE_STAY] = &&write_stay,
+        [KIND_LEFT] = &&move_left,
+        [KIND_RIGHT] = &&move_right,
+        [KIND_STAY] = &&stay,
+        [KIND_HALT] = &&halt
+    };
+
+    struct ThreadedRule* const rules = program->rules;
+    const size_t rules_size = (program->halt + 1) * program->symbol_len;
+
+    if(rules_size > 0 && rules[0].handler == NULL) {
+        for(size_t i = 0; i < rules_size; ++i) {
+            rules[i].handler = handlers[rules[i].kind];
+        }
+    }
+
+    Symbol* content = tape->content;
+    size_t cursor = tape->cursor;
+    size_t remaining = max_iter;
+
+    size_t next = *state * program->symbol_len;
+    const struct ThreadedRule* rule;
+
+    DISPATCH();
+
+write_left:
+    content[cursor] = rule->write_symbol;
+    next = rule->next;
+    MOVE_LEFT();
+    DISPATCH();
+
+write_right:
+    content[cursor] = rule->write_symbol;
+    next = rule->next;
+    MOVE_RIGHT();
+    DISPATCH();
+
+write_stay:
+    content[cursor] = rule->write_symbol;
+    next = rule->next;
+    DISPATCH();
+
+move_left:
+    next = rule->next;
+    MOVE_LEFT();
+    DISPATCH();
+
+move_right:
+    next = rule->next;
+    MOVE_RIGHT();
+    DISPATCH();
+
+stay:
+    next = rule->next;
+    DISPATCH();
+
+halt:
+    // Reaching the halt state is not a step.
+    ++remaining;
+
+stop:
+    tape->cursor = cursor;
+    *state = next / program->symbol_len;
+
+    return max_iter - remaining;
+}
+
+#else
+
+size_t run_threaded(struct ThreadedProgram* const program, struct Tape* const tape, StateId* const state, const size_t max_iter) {
+    const struct ThreadedRule* const rules = program->rules;
+
+    Symbol* content = tape->content;
+    size_t cursor = tape->cursor;
+    size_t remaining = max_iter;
+
+    size_t next = *state * program->symbol_len;
+
+    while(remaining > 0) {
+        const struct ThreadedRule* const rule = &rules[next + content[cursor]];
+
+        if(rule->kind == KIND_HALT) {
+            break;
+        }
+
+        --remaining;
+        next = rule->next;
+
+        switch(rule->kind) {
+        case KIND_WRITE_LEFT:
+            content[cursor] = rule->write_symbol;
+            // fallthrough
+        case KIND_LEFT:
+            MOVE_LEFT();
+            break;
+        case KIND_WRITE_RIGHT:
+            content[cursor] = rule->write_symbol;
+            // fallthrough
+        case KIND_RIGHT:
+            MOVE_RIGHT();
+            break;
+        case KIND_WRITE_STAY:
+            content[cursor] = rule->write_symbol;
+            break;
+        default:
+            break;
+        }
+    }
+
+    tape->cursor = cursor;
+    *state = next / program->symbol_len;
+
+    return max_iter - remaining;
+}
+
+#endif
+
+void free_threaded(struct ThreadedProgram* const program) {
+    free(program->rules);
+    program->rules = NULL;
+}
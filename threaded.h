@@ -0,0 +1,53 @@
+#pragma once
+
+#include "table.h"
+
+/* What a transition does. The kinds are decided when the
+ * program is created so that the interpreter does not have to
+ * check the direction or if the symbol changes on every step.
+ */
+enum TransitionKind {
+    KIND_WRITE_LEFT,
+    KIND_WRITE_RIGHT,
+    KIND_WRITE_STAY,
+    KIND_LEFT,
+    KIND_RIGHT,
+    KIND_STAY,
+    // Only used by the rules of the halt state.
+    KIND_HALT
+};
+
+struct ThreadedRule {
+    // The address of the code for the kind of the rule.
+    // It is set by the interpreter as it is the only one that knows it.
+    const void* handler;
+
+    // The index of the first rule of the next state.
+    size_t next;
+
+    Symbol write_symbol;
+    enum TransitionKind kind;
+};
+
+/* The rules of a machine for the threaded interpreter.
+ * Like the transition table, the rules are stored state-major,
+ * but the halt state also gets its own rules.
+ */
+struct ThreadedProgram {
+    struct ThreadedRule* rules;
+
+    size_t symbol_len;
+    StateId halt;
+};
+
+void compile_threaded(struct ThreadedProgram* const program, const struct TransitionTable* const table);
+
+/* Runs the program on the tape until the halt state is reached
+ * or `max_iter` steps have been executed. With GCC and Clang every
+ * rule jumps directly to the code of the next rule (computed goto).
+ *
+ * @return The amount of steps that were executed.
+ */
+size_t run_threaded(struct ThreadedProgram* const program, struct Tape* const tape, StateId* const state, const size_t max_iter);
+
+void free_threaded(struct ThreadedProgram* const program);
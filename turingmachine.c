@@ -20,3 +20,11 @@ void next_state(struct TuringMachine* const machine) {
         break;
     }
 }
+
+void free_machine(struct TuringMachine* const machine) {
+    // The arena is copied, as the machine itself is part of it.
+    struct Arena arena = machine->arena;
+
+    free_tape(&machine->tape);
+    free_arena(&arena);
+}
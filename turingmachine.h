@@ -1,5 +1,6 @@
 #pragma once
 
+#include "arena.h"
 #include "tape.h"
 
 enum Direction {
@@ -26,6 +27,15 @@ struct TuringMachine {
     struct Tape tape;
 
     const struct State* state;
+
+    struct State* states;
+    size_t states_size;
+
+    // The states, their rules and all names (including the machine itself) are allocated from here.
+    struct Arena arena;
 };
 
 void next_state(struct TuringMachine* const machine);
+
+// Frees the tape and everything that was allocated from the arena of the machine.
+void free_machine(struct TuringMachine* const machine);